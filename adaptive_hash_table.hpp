@@ -0,0 +1,228 @@
+#ifndef ADAPTIVE_HASH_TABLE_HPP
+#define ADAPTIVE_HASH_TABLE_HPP
+
+#include "distributed_hash_table.hpp"
+#include "lock_free_hash_table.hpp"
+#include "coarse_grained_hash_table.hpp"
+#include "fine_grained_hash_table.hpp"
+#include <memory>
+
+// Tabla adaptativa: elige en tiempo de ejecución entre Lock-Free, Coarse-Grained
+// y Fine-Grained. La mejor estrategia depende del número de procesos y de la
+// proporción de lecturas, así que se mide en lugar de fijarla a mano.
+//
+// Las tres estrategias son vistas sobre la MISMA ventana (todas usan DHT_Bucket),
+// por lo que cambiar de protocolo no copia datos: solo se cierra la época RMA
+// de la estrategia saliente y se abre la de la entrante en un límite de paso.
+class AdaptiveHashTable final : public DistributedHashTable {
+private:
+    static constexpr int NUM_STRATEGIES = 3;
+
+    enum class Phase { EXPLORING, EXPLOITING };
+
+    std::unique_ptr<DistributedHashTable> strategies[NUM_STRATEGIES];
+    int active = 0;
+
+    // Configuración
+    int sample_steps;          // Pasos por ventana de muestreo
+    double drift_threshold;    // Cambio en proporción de lecturas que fuerza re-exploración
+    double slowdown_threshold; // Empeoramiento relativo del paso que fuerza re-exploración
+
+    // Estado del muestreo
+    Phase phase = Phase::EXPLORING;
+    double last_boundary = -1.0;
+    double window_time = 0.0;
+    int window_steps = 0;
+    int steps_done = 0;
+    double explore_step_time[NUM_STRATEGIES] = {0.0, 0.0, 0.0};
+    double chosen_step_time = 0.0;
+    double chosen_read_ratio = 0.0;
+
+    // Efecto de la última decisión (se informa al cerrar la ventana siguiente)
+    bool effect_pending = false;
+    double step_time_before_switch = 0.0;
+    int switched_from = 0;
+
+public:
+    AdaptiveHashTable(int total_entries, int rank, int size,
+                      int sample_steps = 3, double drift_threshold = 0.2,
+                      double slowdown_threshold = 0.25)
+        : DistributedHashTable(total_entries, rank, size),
+          sample_steps(sample_steps > 0 ? sample_steps : 1),
+          drift_threshold(drift_threshold),
+          slowdown_threshold(slowdown_threshold) {
+
+        WindowView view = getWindowView();
+        strategies[0] = std::make_unique<LockFreeHashTable>(view);
+        strategies[1] = std::make_unique<CoarseGrainedHashTable>(view);
+        strategies[2] = std::make_unique<FineGrainedHashTable>(view);
+
+        strategies[active]->beginAccessEpoch();
+    }
+
+    ~AdaptiveHashTable() {
+        // Cerrar la época antes de que la clase base libere la ventana
+        strategies[active]->endAccessEpoch();
+    }
+
+    void updateCell(int key, const GridCell& val) override {
+        strategies[active]->updateCell(key, val);
+    }
+
+    GridCell getCell(int key) override {
+        return strategies[active]->getCell(key);
+    }
+
+    std::string getStrategyName() const override {
+        return "Adaptive (" + strategies[active]->getStrategyName() + ")";
+    }
+
+    void syncGhostCells() override {
+        strategies[active]->syncGhostCells();
+    }
+
+    void startFetch(FetchBatch& batch) override { strategies[active]->startFetch(batch); }
+    void completeFetch(FetchBatch& batch) override { strategies[active]->completeFetch(batch); }
+    bool decodeFetched(const DHT_Bucket& b, int key, GridCell& out) override {
+        return strategies[active]->decodeFetched(b, key, out);
+    }
+
+    // La época abierta es siempre la de la estrategia activa
+    void beginAccessEpoch() override { strategies[active]->beginAccessEpoch(); }
+    void endAccessEpoch() override { strategies[active]->endAccessEpoch(); }
+    void adoptLocalBuckets() override { strategies[active]->adoptLocalBuckets(); }
+
+    // Cada sample_steps pasos se agregan las métricas de todos los procesos y
+    // se decide (colectivamente, con el mismo resultado en todos) si cambiar.
+    void stepBoundary() override {
+        double now = MPI_Wtime();
+        if (last_boundary < 0.0) {
+            // Primer límite (fin de la inicialización): solo marca el inicio
+            last_boundary = now;
+            strategies[active]->resetMetrics();
+            return;
+        }
+        window_time += now - last_boundary;
+        last_boundary = now;
+        window_steps++;
+        steps_done++;
+
+        if (window_steps < sample_steps) return;
+
+        // Agregado global: contadores sumados, tiempo del proceso más lento
+        const DHT_Metrics& m = strategies[active]->getMetrics();
+        double local_counts[4] = {(double)m.reads, (double)m.writes,
+                                  (double)m.retries, m.lock_wait_s};
+        double global_counts[4];
+        MPI_Allreduce(local_counts, global_counts, 4, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+        double global_window_time;
+        MPI_Allreduce(&window_time, &global_window_time, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+
+        double ops = global_counts[0] + global_counts[1];
+        double read_ratio = ops > 0 ? global_counts[0] / ops : 0.0;
+        double retry_rate = ops > 0 ? global_counts[2] / ops : 0.0;
+        double lock_wait_us = ops > 0 ? global_counts[3] / ops * 1e6 : 0.0;
+        double step_time = global_window_time / window_steps;
+
+        window_time = 0.0;
+        window_steps = 0;
+        strategies[active]->resetMetrics();
+
+        if (rank == 0) {
+            std::cout << "[Adaptive] step " << steps_done << " "
+                      << strategies[active]->getStrategyName()
+                      << ": " << step_time * 1000.0 << " ms/step"
+                      << ", reads " << read_ratio * 100.0 << "%"
+                      << ", retries/op " << retry_rate
+                      << ", lock wait " << lock_wait_us << " us/op" << std::endl;
+        }
+
+        if (effect_pending) {
+            effect_pending = false;
+            if (rank == 0) {
+                std::cout << "[Adaptive] effect of switch "
+                          << strategies[switched_from]->getStrategyName() << " -> "
+                          << strategies[active]->getStrategyName() << ": "
+                          << step_time_before_switch * 1000.0 << " -> "
+                          << step_time * 1000.0 << " ms/step ("
+                          << (step_time / step_time_before_switch - 1.0) * 100.0
+                          << "%)" << std::endl;
+            }
+        }
+
+        if (phase == Phase::EXPLORING) {
+            explore_step_time[active] = step_time;
+            if (active + 1 < NUM_STRATEGIES) {
+                switchTo(active + 1, step_time, "exploring");
+                return;
+            }
+
+            int best = 0;
+            for (int i = 1; i < NUM_STRATEGIES; ++i) {
+                if (explore_step_time[i] < explore_step_time[best]) best = i;
+            }
+            phase = Phase::EXPLOITING;
+            chosen_step_time = explore_step_time[best];
+            chosen_read_ratio = read_ratio;
+            if (best != active) {
+                switchTo(best, step_time, "fastest sampled");
+            } else if (rank == 0) {
+                std::cout << "[Adaptive] keeping " << strategies[active]->getStrategyName()
+                          << " (fastest sampled)" << std::endl;
+            }
+            return;
+        }
+
+        // EXPLOITING: re-explorar si cambia la carga o el rendimiento se degrada
+        bool drifted = std::abs(read_ratio - chosen_read_ratio) > drift_threshold;
+        bool slowed = step_time > chosen_step_time * (1.0 + slowdown_threshold);
+        if (drifted || slowed) {
+            phase = Phase::EXPLORING;
+            if (active != 0) {
+                switchTo(0, step_time, drifted ? "read ratio drift, re-exploring"
+                                               : "slowdown, re-exploring");
+            } else if (rank == 0) {
+                std::cout << "[Adaptive] re-exploring ("
+                          << (drifted ? "read ratio drift" : "slowdown") << ")" << std::endl;
+            }
+        }
+    }
+
+protected:
+    // Tras crecer la ventana, las vistas se rehacen sobre la nueva
+    void onWindowReplaced() override {
+        WindowView view = getWindowView();
+        strategies[0] = std::make_unique<LockFreeHashTable>(view);
+        strategies[1] = std::make_unique<CoarseGrainedHashTable>(view);
+        strategies[2] = std::make_unique<FineGrainedHashTable>(view);
+    }
+
+private:
+    // Cambio colectivo de protocolo. Los datos se quedan en su sitio: solo se
+    // cambian las épocas RMA y se adaptan los buckets locales (checksums).
+    void switchTo(int next, double current_step_time, const char* reason) {
+        if (rank == 0) {
+            std::cout << "[Adaptive] switching "
+                      << strategies[active]->getStrategyName() << " -> "
+                      << strategies[next]->getStrategyName()
+                      << " (" << reason << ")" << std::endl;
+        }
+
+        strategies[active]->endAccessEpoch();  // Completa todas las operaciones pendientes
+        MPI_Barrier(MPI_COMM_WORLD);
+        strategies[next]->adoptLocalBuckets();
+        MPI_Barrier(MPI_COMM_WORLD);
+        strategies[next]->beginAccessEpoch();
+
+        switched_from = active;
+        active = next;
+        strategies[active]->resetMetrics();
+        step_time_before_switch = current_step_time;
+        effect_pending = true;
+
+        // El tiempo del cambio no cuenta para la siguiente ventana
+        last_boundary = MPI_Wtime();
+    }
+};
+
+#endif // ADAPTIVE_HASH_TABLE_HPP
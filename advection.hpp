@@ -0,0 +1,192 @@
+#ifndef ADVECTION_HPP
+#define ADVECTION_HPP
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include "distributed_hash_table.hpp"
+
+// === Advección upwind sobre teselas locales ===
+//
+// Volúmenes finitos con separación direccional (barrido en x y después en y)
+// y contornos periódicos, igual que la difusión. El campo de velocidad es
+// u(y) = velocity_x + velocity_shear * (y / grid_y - 0.5), v = velocity_y:
+// u solo depende de la fila, así que el campo es de divergencia nula y el
+// esquema conserva la masa de cada especie.
+//
+// Cada tesela cubre filas completas de la malla más un halo de filas arriba y
+// abajo. Con sub-pasos CFL el halo se ensancha (order filas por sub-paso) para
+// que todos los sub-pasos se hagan sin volver a comunicar: la zona válida
+// se estrecha order filas por lado en cada barrido en y.
+
+struct VelocityField {
+    double u, v, shear;
+    int grid_y;
+
+    explicit VelocityField(const SimulationParams& params)
+        : u(params.velocity_x), v(params.velocity_y),
+          shear(params.velocity_shear), grid_y(params.grid_y) {}
+
+    // y puede caer fuera de la malla en las filas de halo (contorno periódico)
+    double uAt(int y) const {
+        y = ((y % grid_y) + grid_y) % grid_y;
+        return u + shear * ((y + 0.5) / grid_y - 0.5);
+    }
+
+    double maxSpeed() const {
+        return std::max({std::abs(u - 0.5 * shear), std::abs(u + 0.5 * shear), std::abs(v)});
+    }
+};
+
+// Concentraciones de una tesela en SoA: una fila de la malla por especie,
+// con GHOST columnas fantasma a cada lado para el contorno periódico en x
+class AdvectionTile {
+public:
+    static constexpr int GHOST = 2;
+
+private:
+    int num_species, nx, rows;
+    int first_row; // Fila global de la fila 0 de la tesela (puede ser negativa)
+    std::vector<double> data;
+
+public:
+    AdvectionTile(int num_species, int nx, int first_row, int rows)
+        : num_species(num_species), nx(nx), rows(rows), first_row(first_row),
+          data(static_cast<size_t>(num_species) * rows * (nx + 2 * GHOST), 0.0) {}
+
+    int getRows() const { return rows; }
+    int getFirstRow() const { return first_row; }
+
+    // Puntero a la columna x = 0 de la fila r de la especie s
+    double* row(int s, int r) {
+        return data.data() + (static_cast<size_t>(s) * rows + r) * (nx + 2 * GHOST) + GHOST;
+    }
+};
+
+class UpwindAdvection {
+private:
+    int nx, num_species, order;
+    VelocityField field;
+
+public:
+    UpwindAdvection(const SimulationParams& params)
+        : nx(params.grid_x), num_species(params.num_species),
+          order(params.advection_order == 1 ? 1 : 2), field(params) {}
+
+    int getOrder() const { return order; }
+
+    // Sub-pasos necesarios para que |vel| * dt_sub <= cfl (dx = 1 celda)
+    static int substepsFor(const SimulationParams& params) {
+        double courant = VelocityField(params).maxSpeed() * params.dt;
+        int n = static_cast<int>(std::ceil(courant / params.cfl));
+        return std::max(1, n);
+    }
+
+    // Filas de halo por lado que necesita un paso completo
+    int haloRows(int substeps) const { return order * substeps; }
+
+    // Avanza dt en substeps sub-pasos. Al terminar son válidas las filas
+    // [haloRows(substeps), rows - haloRows(substeps)) de la tesela.
+    void advect(AdvectionTile& tile, double dt, int substeps) const {
+        const double h = dt / substeps;
+        int lo = 0, hi = tile.getRows();
+        for (int step = 0; step < substeps; ++step) {
+            sweepX(tile, lo, hi, h);
+            sweepY(tile, lo, hi, h);
+            lo += order;
+            hi -= order;
+        }
+    }
+
+private:
+    // Pendiente limitada (minmod): 0 en extremos locales, evita oscilaciones
+    static inline double minmod(double a, double b) {
+        if (a * b <= 0.0) return 0.0;
+        return std::abs(a) < std::abs(b) ? a : b;
+    }
+
+    // Flujo upwind en una cara con velocidad vel entre las celdas de valores
+    // (c_mm, c_m | c_p, c_pp): donor-cell o reconstrucción lineal limitada
+    inline double faceFlux(double vel, double courant, double c_mm, double c_m,
+                           double c_p, double c_pp) const {
+        if (order == 1) return vel * (vel >= 0.0 ? c_m : c_p);
+        double corr = 0.5 * (1.0 - courant);
+        if (vel >= 0.0) return vel * (c_m + corr * minmod(c_m - c_mm, c_p - c_m));
+        return vel * (c_p - corr * minmod(c_p - c_m, c_pp - c_p));
+    }
+
+    // Barrido en x: las filas son completas, el halo en x es la propia fila
+    void sweepX(AdvectionTile& tile, int lo, int hi, double h) const {
+        #pragma omp parallel
+        {
+            std::vector<double> flux(nx + 1);
+            double* f = flux.data();
+
+            #pragma omp for collapse(2) schedule(static)
+            for (int s = 0; s < num_species; ++s) {
+                for (int r = lo; r < hi; ++r) {
+                    double* c = tile.row(s, r);
+                    for (int g = 1; g <= AdvectionTile::GHOST; ++g) {
+                        c[-g] = c[nx - g];
+                        c[nx - 1 + g] = c[g - 1];
+                    }
+
+                    const double vel = field.uAt(tile.getFirstRow() + r);
+                    const double courant = std::abs(vel) * h;
+
+                    // f[i] = flujo por la cara izquierda de la celda i
+                    #pragma omp simd
+                    for (int i = 0; i <= nx; ++i) {
+                        f[i] = faceFlux(vel, courant, c[i - 2], c[i - 1], c[i], c[i + 1]);
+                    }
+                    #pragma omp simd
+                    for (int i = 0; i < nx; ++i) c[i] -= h * (f[i + 1] - f[i]);
+                }
+            }
+        }
+    }
+
+    // Barrido en y: vectorizado sobre x, una cara entre filas cada vez
+    void sweepY(AdvectionTile& tile, int lo, int hi, double h) const {
+        const double vel = field.v;
+        const double courant = std::abs(vel) * h;
+        // Filas actualizables: necesitan order filas válidas a cada lado
+        const int first = lo + order, last = hi - order;
+        if (first >= last) return;
+
+        // flux[s][k] = flujo por la cara inferior de la fila first + k
+        const size_t faces = static_cast<size_t>(last - first + 1);
+        std::vector<double> flux(num_species * faces * nx);
+
+        #pragma omp parallel
+        {
+            #pragma omp for collapse(2) schedule(static)
+            for (int s = 0; s < num_species; ++s) {
+                for (int r = first; r <= last; ++r) {
+                    const double* c_mm = tile.row(s, std::max(lo, r - 2));
+                    const double* c_m = tile.row(s, r - 1);
+                    const double* c_p = tile.row(s, r);
+                    const double* c_pp = tile.row(s, std::min(hi - 1, r + 1));
+                    double* f = flux.data() + (s * faces + (r - first)) * nx;
+                    #pragma omp simd
+                    for (int x = 0; x < nx; ++x) {
+                        f[x] = faceFlux(vel, courant, c_mm[x], c_m[x], c_p[x], c_pp[x]);
+                    }
+                }
+            }
+
+            #pragma omp for collapse(2) schedule(static)
+            for (int s = 0; s < num_species; ++s) {
+                for (int r = first; r < last; ++r) {
+                    double* c = tile.row(s, r);
+                    const double* f_in = flux.data() + (s * faces + (r - first)) * nx;
+                    const double* f_out = f_in + nx;
+                    #pragma omp simd
+                    for (int x = 0; x < nx; ++x) c[x] -= h * (f_out[x] - f_in[x]);
+                }
+            }
+        }
+    }
+};
+
+#endif // ADVECTION_HPP
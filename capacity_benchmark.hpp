@@ -0,0 +1,136 @@
+#ifndef CAPACITY_BENCHMARK_HPP
+#define CAPACITY_BENCHMARK_HPP
+
+#include <vector>
+#include <iostream>
+#include <string>
+#include <mpi.h>
+#include "distributed_hash_table.hpp"
+
+// Inserción por rondas de claves nuevas hasta superar varias veces la
+// capacidad inicial. Con GROW cada ronda termina en growAtBoundary (crecimiento
+// + reescritura de las aplazadas), que se mide aparte de las inserciones; en
+// modo caché la capacidad es fija y al final se relee todo para medir la tasa
+// de aciertos. Colectivo: todos los procesos lo ejecutan a la vez.
+class CapacityBenchmark {
+private:
+    DistributedHashTable& dht;
+    int rank, size;
+
+public:
+    CapacityBenchmark(DistributedHashTable& table, int rank, int size)
+        : dht(table), rank(rank), size(size) {}
+
+    struct RoundResult {
+        size_t capacity;        // Buckets por proceso al terminar la ronda
+        bool grew;
+        double insert_s;        // Máximo entre procesos
+        double boundary_s;      // growAtBoundary: crecimiento + reescrituras
+        long long deferred;     // Escrituras aplazadas en la ronda (todos los procesos)
+        double insert_ops_per_sec;    // Solo las escrituras hechas en la ronda
+        double effective_ops_per_sec; // Contando también el límite de paso
+    };
+
+    struct BenchmarkResult {
+        std::vector<RoundResult> rounds;
+        long long total_keys = 0;
+        long long deferred = 0;
+        long long evictions = 0;
+        double hit_rate = 0.0;  // Claves releídas con su valor / insertadas
+    };
+
+    BenchmarkResult runInsertPastCapacity(int keys_per_rank_per_round, int rounds) {
+        BenchmarkResult result;
+        dht.resetMetrics();
+        const long long deferred_start = dht.getDeferredCount();
+
+        for (int round = 0; round < rounds; ++round) {
+            long long deferred_before = dht.getDeferredCount();
+            MPI_Barrier(MPI_COMM_WORLD);
+            double t0 = MPI_Wtime();
+            for (int i = 0; i < keys_per_rank_per_round; ++i) {
+                int key = keyFor(round, i, keys_per_rank_per_round);
+                dht.updateCell(key, valueFor(key));
+            }
+            dht.syncGhostCells();
+            double t1 = MPI_Wtime();
+            long long deferred_in_round = dht.getDeferredCount() - deferred_before;
+            bool grew = dht.growAtBoundary();
+            double t2 = MPI_Wtime();
+
+            double local[2] = {t1 - t0, t2 - t1}, global[2];
+            MPI_Allreduce(local, global, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+            // Las aplazadas se cuentan antes de growAtBoundary, que las reescribe
+            // (y puede volver a aplazar las que no consigan lock)
+            long long local_deferred = deferred_in_round, round_deferred;
+            MPI_Allreduce(&local_deferred, &round_deferred, 1, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+
+            // Una escritura aplazada no se ha insertado durante la fase de
+            // inserción: solo cuenta en el rendimiento efectivo
+            double ops = static_cast<double>(keys_per_rank_per_round) * size;
+            double inserted = ops - static_cast<double>(round_deferred);
+            RoundResult r;
+            r.capacity = dht.getLocalCapacity();
+            r.grew = grew;
+            r.insert_s = global[0];
+            r.boundary_s = global[1];
+            r.deferred = round_deferred;
+            r.insert_ops_per_sec = global[0] > 0.0 ? inserted / global[0] : 0.0;
+            r.effective_ops_per_sec = (global[0] + global[1]) > 0.0 ? ops / (global[0] + global[1]) : 0.0;
+            result.rounds.push_back(r);
+        }
+
+        // Relectura de las claves propias
+        long long hits = 0;
+        for (int round = 0; round < rounds; ++round) {
+            for (int i = 0; i < keys_per_rank_per_round; ++i) {
+                int key = keyFor(round, i, keys_per_rank_per_round);
+                GridCell cell = dht.getCell(key);
+                if (cell.concentrations[0] == valueFor(key).concentrations[0]) hits++;
+            }
+        }
+
+        long long local_counts[3] = {hits, dht.getDeferredCount() - deferred_start,
+                                     dht.getMetrics().evictions};
+        long long counts[3];
+        MPI_Allreduce(local_counts, counts, 3, MPI_LONG_LONG, MPI_SUM, MPI_COMM_WORLD);
+        result.total_keys = static_cast<long long>(keys_per_rank_per_round) * rounds * size;
+        result.deferred = counts[1];
+        result.evictions = counts[2];
+        result.hit_rate = result.total_keys > 0 ? (double)counts[0] / result.total_keys : 0.0;
+        return result;
+    }
+
+    void printResults(const BenchmarkResult& result, const std::string& benchmark_name) {
+        if (rank == 0) {
+            std::cout << "=== " << benchmark_name << " ===" << std::endl;
+            for (size_t r = 0; r < result.rounds.size(); ++r) {
+                const RoundResult& rr = result.rounds[r];
+                std::cout << "  round " << r << ": capacity " << rr.capacity << "/rank"
+                          << (rr.grew ? " (grew)" : "")
+                          << " | deferred " << rr.deferred
+                          << " | insert " << rr.insert_ops_per_sec / 1e6 << " Mops/s"
+                          << ", boundary " << rr.boundary_s * 1000.0 << " ms"
+                          << ", effective " << rr.effective_ops_per_sec / 1e6 << " Mops/s"
+                          << std::endl;
+            }
+            std::cout << "  keys " << result.total_keys << ", deferred " << result.deferred
+                      << ", evictions " << result.evictions << ", hit rate "
+                      << result.hit_rate * 100.0 << "%" << std::endl;
+        }
+    }
+
+private:
+    // Claves nuevas en cada ronda y repartidas entre todos los dueños
+    int keyFor(int round, int i, int keys_per_round) const {
+        return (round * keys_per_round + i) * size + (rank + i) % size;
+    }
+
+    static GridCell valueFor(int key) {
+        GridCell cell;
+        for (int s = 0; s < 5; ++s) cell.concentrations[s] = key + 1.0 + 0.1 * s; // Nunca 0 (celda vacía)
+        return cell;
+    }
+};
+
+#endif // CAPACITY_BENCHMARK_HPP
@@ -2,14 +2,34 @@
 #define COARSE_GRAINED_HASH_TABLE_HPP
 
 #include "distributed_hash_table.hpp"
+#include <random>
+
+class CoarseGrainedHashTable final : public DistributedHashTable {
+private:
+    // Modo caché, en el tag de la palabra de control: bit 0 = referencia de
+    // CLOCK del bucket; bits 1-8 = manecilla del conjunto que empieza en ese
+    // bucket. La manecilla vive en la ventana del dueño, así que todos los
+    // escritores comparten el mismo CLOCK por conjunto sin memoria propia.
+    static constexpr uint32_t CLOCK_REFERENCED = 1;
+    static constexpr int CLOCK_HAND_SHIFT = 1;
+    static constexpr uint32_t CLOCK_HAND_MASK = 0xFF;
+    static constexpr size_t MAX_CACHE_WAYS = CLOCK_HAND_MASK + 1;
+
+    std::mt19937 victim_rng;
 
-class CoarseGrainedHashTable : public DistributedHashTable {
 public:
     CoarseGrainedHashTable(int total_entries, int rank, int size)
-        : DistributedHashTable(total_entries, rank, size) {}
+        : DistributedHashTable(total_entries, rank, size), victim_rng(rank) {}
+
+    explicit CoarseGrainedHashTable(const WindowView& view)
+        : DistributedHashTable(view), victim_rng(view.rank) {}
 
     // Escritura Remota (Sección 3.1 del Paper)
     void updateCell(int key, const GridCell& val) override {
+        // Clave fuera de la región: con GROW se aplaza sin recorrer sondeos
+        // que solo encontrarían buckets ocupados
+        if (deferIfOverflow(key, val)) return;
+
         int target_rank = getOwnerRank(key);
         // Desplazamiento inicial (hash)
         MPI_Aint target_offset = getLocalOffset(key);
@@ -18,8 +38,16 @@ public:
         // "Whenever an DHT_read or DHT_write operation is initiated... 
         // the entire memory window... is locked." [cite: 146-147]
         // Usamos LOCK_EXCLUSIVE para escrituras.
+        metrics.writes++;
+        double wait_start = MPI_Wtime();
         MPI_Win_lock(MPI_LOCK_EXCLUSIVE, target_rank, 0, win);
 
+        if (overflow->policy != OverflowPolicy::GROW) {
+            writeCached(target_rank, target_offset, key, val, wait_start);
+            MPI_Win_unlock(target_rank, win);
+            return;
+        }
+
         DHT_Bucket temp;
         bool written = false;
         int attempts = 0;
@@ -35,13 +63,16 @@ public:
             
             // Forzamos que la lectura termine antes de verificar (Flush local)
             MPI_Win_flush(target_rank, win);
+            // MPI puede diferir el lock hasta la primera operación: la espera
+            // real termina cuando se completa el primer flush
+            if (attempts == 0) metrics.lock_wait_s += MPI_Wtime() - wait_start;
 
             // Verificamos si podemos escribir aquí
-            if (temp.status == 0 || temp.key == key) {
+            if (bucketState(temp.control) == BUCKET_EMPTY || temp.key == key) {
                 // Preparamos el bucket a escribir
                 temp.key = key;
                 temp.value = val;
-                temp.status = 1; // Ocupado
+                temp.control = makeControl(BUCKET_OCCUPIED, 0); // Ocupado
 
                 // Escribimos (Remote Write)
                 MPI_Put(&temp, sizeof(DHT_Bucket), MPI_BYTE,
@@ -55,11 +86,15 @@ public:
             // Colisión: Intentar siguiente slot
             target_offset = (target_offset + 1) % local_capacity;
             attempts++;
+            metrics.retries++;
         }
 
         // 3. DESBLOQUEO
         // "The lock is released with MPI_Win_unlock" [cite: 149]
         MPI_Win_unlock(target_rank, win);
+
+        // Región llena alrededor de la clave: crecer en el siguiente límite de paso
+        if (!written) deferWrite(key, val, local_capacity + 1);
     }
 
     // Lectura Remota
@@ -69,11 +104,14 @@ public:
         GridCell result; // Por defecto vacía
 
         // Usamos LOCK_SHARED para lecturas (permite múltiples lectores) [cite: 148]
+        metrics.reads++;
+        double wait_start = MPI_Wtime();
         MPI_Win_lock(MPI_LOCK_SHARED, target_rank, 0, win);
 
         DHT_Bucket temp;
         int attempts = 0;
-        const int MAX_ATTEMPTS = 50;
+        const bool cache_mode = overflow->policy != OverflowPolicy::GROW;
+        const int MAX_ATTEMPTS = cache_mode ? overflow->cache_ways : 50;
 
         while (attempts < MAX_ATTEMPTS) {
             // Leer bucket remoto
@@ -82,8 +120,9 @@ public:
                     sizeof(DHT_Bucket), MPI_BYTE, win);
             
             MPI_Win_flush(target_rank, win);
+            if (attempts == 0) metrics.lock_wait_s += MPI_Wtime() - wait_start;
 
-            if (temp.status == 0) {
+            if (bucketState(temp.control) == BUCKET_EMPTY) {
                 // Llegamos a un hueco vacío -> La clave no existe
                 break;
             }
@@ -91,18 +130,55 @@ public:
             if (temp.key == key) {
                 // ¡Encontrado!
                 result = temp.value;
+                // CLOCK: marcar como referenciado (atómico frente a otros lectores)
+                if (overflow->policy == OverflowPolicy::EVICT_CLOCK &&
+                    !(bucketTag(temp.control) & CLOCK_REFERENCED)) {
+                    uint32_t ref_bit = makeControl(BUCKET_EMPTY, CLOCK_REFERENCED);
+                    MPI_Accumulate(&ref_bit, 1, MPI_UINT32_T, target_rank,
+                                   target_offset * sizeof(DHT_Bucket) + offsetof(DHT_Bucket, control),
+                                   1, MPI_UINT32_T, MPI_BOR, win);
+                    MPI_Win_flush(target_rank, win);
+                }
                 break;
             }
 
             // Seguir buscando (Linear Probing)
             target_offset = (target_offset + 1) % local_capacity;
             attempts++;
+            metrics.retries++;
         }
 
         MPI_Win_unlock(target_rank, win);
         return result;
     }
 
+    // Un lock compartido por proceso destino para todo su grupo de lecturas,
+    // en lugar de uno por lectura. El lote se completa aquí mismo: mantener el
+    // lock compartido mientras se calcula bloquearía los LOCK_EXCLUSIVE que los
+    // demás procesos toman sobre su propia ventana (interbloqueo), así que esta
+    // estrategia agrupa pero no solapa.
+    void startFetch(FetchBatch& batch) override {
+        batch.buckets.resize(batch.keys.size());
+        std::vector<std::vector<size_t>> by_target(size);
+        for (size_t i = 0; i < batch.keys.size(); ++i) {
+            by_target[getOwnerRank(batch.keys[i])].push_back(i);
+        }
+        for (int target_rank = 0; target_rank < size; ++target_rank) {
+            if (by_target[target_rank].empty()) continue;
+            MPI_Win_lock(MPI_LOCK_SHARED, target_rank, 0, win);
+            for (size_t i : by_target[target_rank]) {
+                MPI_Get(&batch.buckets[i], sizeof(DHT_Bucket), MPI_BYTE,
+                        target_rank, getLocalOffset(batch.keys[i]) * sizeof(DHT_Bucket),
+                        sizeof(DHT_Bucket), MPI_BYTE, win);
+            }
+            MPI_Win_unlock(target_rank, win);
+        }
+        metrics.reads += batch.keys.size();
+    }
+
+    // Sin época abierta no hay nada que completar
+    void completeFetch(FetchBatch&) override {}
+
     std::string getStrategyName() const override {
         return "Coarse-Grained (MPI_Win_lock)";
     }
@@ -111,6 +187,107 @@ public:
     void syncGhostCells() override {
         MPI_Barrier(MPI_COMM_WORLD);
     }
+
+private:
+    // Modo caché (con el lock exclusivo ya tomado): el conjunto son cache_ways
+    // buckets desde la posición inicial y se lee con una sola operación. Se
+    // usa la coincidencia o el primer hueco; si no hay, se desaloja una víctima.
+    // Sin borrados no quedan huecos dentro de un conjunto, así que getCell
+    // puede seguir parando en el primer bucket vacío.
+    void writeCached(int target_rank, size_t home, int key, const GridCell& val,
+                     double wait_start) {
+        const int ways = static_cast<int>(
+            std::min({static_cast<size_t>(overflow->cache_ways), local_capacity, MAX_CACHE_WAYS}));
+        std::vector<DHT_Bucket> set(ways);
+        getRun(target_rank, home, ways, set.data());
+        MPI_Win_flush(target_rank, win);
+        metrics.lock_wait_s += MPI_Wtime() - wait_start;
+
+        int slot = -1;
+        for (int i = 0; i < ways; ++i) {
+            if (bucketState(set[i].control) == BUCKET_EMPTY || set[i].key == key) {
+                slot = i;
+                break;
+            }
+            metrics.retries++;
+        }
+        std::vector<bool> dirty(ways, false); // Palabras de control cambiadas en set
+        if (slot < 0) {
+            slot = chooseVictim(set, dirty);
+            metrics.evictions++;
+        }
+
+        // El bucket escrito conserva la manecilla del conjunto que empieza en él
+        DHT_Bucket b;
+        b.key = key;
+        b.value = val;
+        b.control = withClockHand(makeControl(BUCKET_OCCUPIED, CLOCK_REFERENCED),
+                                  clockHand(set[slot].control));
+        MPI_Put(&b, sizeof(DHT_Bucket), MPI_BYTE, target_rank,
+                ((home + slot) % local_capacity) * sizeof(DHT_Bucket),
+                sizeof(DHT_Bucket), MPI_BYTE, win);
+
+        // Bits de referencia borrados y manecilla nueva. El bucket escrito ya
+        // lleva los suyos: dos Put al mismo sitio en la misma época no tienen orden
+        for (int i = 0; i < ways; ++i) {
+            if (!dirty[i] || i == slot) continue;
+            MPI_Put(&set[i].control, 1, MPI_UINT32_T, target_rank,
+                    ((home + i) % local_capacity) * sizeof(DHT_Bucket) +
+                        offsetof(DHT_Bucket, control),
+                    1, MPI_UINT32_T, win);
+        }
+        MPI_Win_flush(target_rank, win); // b y set son locales a esta función
+    }
+
+    static int clockHand(uint32_t control) {
+        return static_cast<int>((bucketTag(control) >> CLOCK_HAND_SHIFT) & CLOCK_HAND_MASK);
+    }
+
+    static uint32_t withClockHand(uint32_t control, int hand) {
+        uint32_t tag = bucketTag(control) & ~(CLOCK_HAND_MASK << CLOCK_HAND_SHIFT);
+        tag |= (static_cast<uint32_t>(hand) & CLOCK_HAND_MASK) << CLOCK_HAND_SHIFT;
+        return makeControl(bucketState(control), tag);
+    }
+
+    // CLOCK acotado al conjunto: desde la manecilla (guardada en el bucket
+    // inicial), los referenciados pierden el bit (segunda oportunidad) y el
+    // primero sin bit es la víctima. Solo modifica set y marca en dirty las
+    // palabras de control que cambian; writeCached las escribe.
+    // Aleatorio: cualquiera de los k.
+    int chooseVictim(std::vector<DHT_Bucket>& set, std::vector<bool>& dirty) {
+        const int ways = static_cast<int>(set.size());
+        if (overflow->policy == OverflowPolicy::EVICT_RANDOM) {
+            return std::uniform_int_distribution<int>(0, ways - 1)(victim_rng);
+        }
+
+        const int hand = clockHand(set[0].control) % ways;
+        int victim = -1;
+        for (int n = 0; n < 2 * ways && victim < 0; ++n) {
+            int i = (hand + n) % ways;
+            if (bucketTag(set[i].control) & CLOCK_REFERENCED) {
+                set[i].control = makeControl(bucketState(set[i].control),
+                                             bucketTag(set[i].control) & ~CLOCK_REFERENCED);
+                dirty[i] = true;
+            } else {
+                victim = i;
+            }
+        }
+        set[0].control = withClockHand(set[0].control, (victim + 1) % ways);
+        dirty[0] = true;
+        return victim;
+    }
+
+    // count buckets consecutivos desde start (dos MPI_Get si dan la vuelta)
+    void getRun(int target_rank, size_t start, int count, DHT_Bucket* out) {
+        size_t first = std::min<size_t>(count, local_capacity - start);
+        MPI_Get(out, first * sizeof(DHT_Bucket), MPI_BYTE, target_rank,
+                start * sizeof(DHT_Bucket), first * sizeof(DHT_Bucket), MPI_BYTE, win);
+        if (first < static_cast<size_t>(count)) {
+            size_t rest = count - first;
+            MPI_Get(out + first, rest * sizeof(DHT_Bucket), MPI_BYTE, target_rank,
+                    0, rest * sizeof(DHT_Bucket), MPI_BYTE, win);
+        }
+    }
 };
 
 #endif // COARSE_GRAINED_HASH_TABLE_HPP
\ No newline at end of file
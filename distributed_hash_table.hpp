@@ -9,6 +9,11 @@
 #include <functional> 
 #include <string>
 #include <cstddef> // Para offsetof
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include "ownership_directory.hpp"
 
 // === 1. Estructuras de Datos ===
 
@@ -18,6 +23,24 @@ struct SimulationParams {
     int num_species = 5;
     double dt = 0.1;
     int steps = 1000;
+
+    // Balanceo dinámico de carga (migración de rangos de claves entre procesos)
+    bool load_balancing = false;
+    int lb_blocks_per_rank = 16;         // Granularidad de migración
+    int lb_interval = 5;                 // Pasos entre evaluaciones
+    double lb_imbalance_threshold = 1.10; // Migrar si max/media del trabajo lo supera
+    int lb_max_moves = 4;                // Bloques movidos como máximo por evaluación
+
+    // Solapar comunicación y cálculo: celdas interiores mientras llegan los halos
+    bool overlap_comm = false;
+
+    // Advección upwind antes de la química (velocidades en celdas por unidad de tiempo)
+    bool advection = false;
+    int advection_order = 2;      // 1: donor-cell, 2: upwind con pendiente limitada (minmod)
+    double velocity_x = 1.0;      // u(y) = velocity_x + velocity_shear * (y / grid_y - 0.5)
+    double velocity_y = 0.5;
+    double velocity_shear = 0.5;
+    double cfl = 0.9;             // Número de Courant máximo por sub-paso
 };
 
 struct GridCell {
@@ -30,11 +53,73 @@ struct GridCell {
     }
 };
 
-struct DHT_Bucket {
+// Alineación de los buckets en la ventana. 64 = un bucket por línea de caché;
+// compilar con -DDHT_BUCKET_ALIGN=8 para empaquetado natural.
+#ifndef DHT_BUCKET_ALIGN
+#define DHT_BUCKET_ALIGN 64
+#endif
+
+// Palabra de control del bucket: [ tag (30 bits) | estado (2 bits) ].
+// El tag es el checksum de Lock-Free; Fine-Grained hace CAS sobre la palabra completa.
+enum : uint32_t {
+    BUCKET_EMPTY = 0,
+    BUCKET_OCCUPIED = 1,
+    BUCKET_LOCKED = 2
+};
+constexpr uint32_t BUCKET_STATE_MASK = 0x3;
+
+inline uint32_t bucketState(uint32_t control) { return control & BUCKET_STATE_MASK; }
+inline uint32_t bucketTag(uint32_t control) { return control >> 2; }
+inline uint32_t makeControl(uint32_t state, uint32_t tag) {
+    return (tag << 2) | (state & BUCKET_STATE_MASK);
+}
+
+// Cabecera primero: los atómicos sobre la palabra de control quedan al inicio
+// de la línea de caché y el payload (key + value) es contiguo.
+struct alignas(DHT_BUCKET_ALIGN) DHT_Bucket {
+    uint32_t control;     // Estado + tag
     int key;              
     GridCell value;       
-    int status;           // 0 = Vacío, 1 = Ocupado
-    unsigned int checksum; 
+};
+
+static_assert(sizeof(GridCell) == 56, "GridCell: 5 concentraciones + 2 flujos");
+static_assert(sizeof(DHT_Bucket) == std::max<size_t>(64, DHT_BUCKET_ALIGN),
+              "DHT_Bucket: 64 bytes de datos, rellenados hasta DHT_BUCKET_ALIGN");
+static_assert(offsetof(DHT_Bucket, control) == 0, "La palabra de control va primero");
+
+// Métricas de contención acumuladas por cada estrategia (por proceso)
+struct DHT_Metrics {
+    long long reads = 0;
+    long long writes = 0;
+    long long retries = 0;     // Checksum fallido, sondeo extra o CAS fallido
+    double lock_wait_s = 0.0;  // Tiempo esperando locks (MPI_Win_lock / spin CAS)
+    long long deferred = 0;    // Escrituras aplazadas al siguiente límite de paso
+    long long evictions = 0;   // Entradas desalojadas en modo caché
+};
+
+// Qué hacer con una escritura que no cabe en la región de su dueño
+enum class OverflowPolicy {
+    GROW,         // Aplazarla y hacer crecer la tabla en el siguiente límite de paso
+    EVICT_CLOCK,  // Modo caché: capacidad fija, víctima por CLOCK en el conjunto de sondeo
+    EVICT_RANDOM  // Modo caché: víctima aleatoria entre los k buckets del conjunto
+};
+
+// Estado de capacidad compartido por la tabla y sus vistas: política y
+// escrituras pendientes (las vistas aplazan en la lista de la dueña)
+struct OverflowState {
+    OverflowPolicy policy = OverflowPolicy::GROW;
+    int cache_ways = 8;                // k: buckets por conjunto en modo caché
+    std::vector<std::pair<int, GridCell>> deferred;
+    size_t needed_capacity = 0;        // Capacidad local mínima que piden los aplazamientos
+    int growths = 0;
+    long long total_deferred = 0;      // Aplazamientos acumulados (tabla y vistas)
+};
+
+// Lote de lecturas no bloqueantes: se lanza con startFetch, se completa con
+// completeFetch y cada bucket se interpreta con decodeFetched
+struct FetchBatch {
+    std::vector<int> keys;
+    std::vector<DHT_Bucket> buckets;
 };
 
 // === 2. Clase Base Distribuida ===
@@ -45,16 +130,34 @@ protected:
     DHT_Bucket* local_buffer;    
     int rank, size;
     size_t local_capacity;       
+    bool owns_window = true;     // false si es una vista sobre la ventana de otra tabla
+    bool unified_memory = false; // MPI_WIN_UNIFIED: loads/stores locales ven la ventana pública
+    DHT_Metrics metrics;
+    // Compartido con las vistas sobre la misma ventana
+    std::shared_ptr<OwnershipDirectory> directory;
+    std::shared_ptr<OverflowState> overflow;
+    void* raw_buffer = nullptr;  // Puntero de MPI_Alloc_mem (local_buffer va alineado)
     
 public:
+    // Descripción de una ventana ya creada, para construir vistas sobre ella
+    struct WindowView {
+        MPI_Win win;
+        DHT_Bucket* local_buffer;
+        size_t local_capacity;
+        int rank, size;
+        std::shared_ptr<OwnershipDirectory> directory;
+        std::shared_ptr<OverflowState> overflow;
+    };
+
     DistributedHashTable(int total_expected_entries, int rank, int size) 
-        : rank(rank), size(size) {
+        : rank(rank), size(size),
+          directory(std::make_shared<OwnershipDirectory>(size)),
+          overflow(std::make_shared<OverflowState>()) {
         
         local_capacity = (total_expected_entries / size) * 2;
         if (local_capacity < 100) local_capacity = 100;
 
-        MPI_Alloc_mem(local_capacity * sizeof(DHT_Bucket), MPI_INFO_NULL, &local_buffer);
-        memset(local_buffer, 0, local_capacity * sizeof(DHT_Bucket));
+        local_buffer = allocateBuckets(local_capacity, raw_buffer);
 
         // <--- CAMBIO IMPORTANTE AQUI ABAJO --->
         // Cambiamos el disp_unit de sizeof(DHT_Bucket) a 1.
@@ -66,38 +169,386 @@ public:
                        MPI_INFO_NULL, 
                        MPI_COMM_WORLD, 
                        &win);
+        unified_memory = queryUnifiedModel(win);
     }
 
+protected:
+    // Constructor para backends sin ventana MPI (p. ej. memoria compartida
+    // dentro de un único proceso). La subclase gestiona su propio almacenamiento.
+    DistributedHashTable(int rank, int size)
+        : win(MPI_WIN_NULL), local_buffer(nullptr),
+          rank(rank), size(size), local_capacity(0),
+          directory(std::make_shared<OwnershipDirectory>(size)),
+          overflow(std::make_shared<OverflowState>()) {}
+
+    // Vista sobre la ventana de otra tabla (no la crea ni la libera). Como todas
+    // las estrategias MPI comparten DHT_Bucket, pueden operar sobre la misma memoria.
+    explicit DistributedHashTable(const WindowView& view)
+        : win(view.win), local_buffer(view.local_buffer),
+          rank(view.rank), size(view.size),
+          local_capacity(view.local_capacity), owns_window(false),
+          unified_memory(queryUnifiedModel(view.win)), directory(view.directory),
+          overflow(view.overflow) {}
+
+    // Se reserva DHT_BUCKET_ALIGN de más para alinear el inicio de la ventana:
+    // así cada bucket empieza en su propia línea de caché
+    static DHT_Bucket* allocateBuckets(size_t capacity, void*& raw) {
+        size_t bytes = capacity * sizeof(DHT_Bucket);
+        MPI_Alloc_mem(bytes + DHT_BUCKET_ALIGN, MPI_INFO_NULL, &raw);
+        uintptr_t addr = reinterpret_cast<uintptr_t>(raw);
+        addr = (addr + DHT_BUCKET_ALIGN - 1) & ~static_cast<uintptr_t>(DHT_BUCKET_ALIGN - 1);
+        DHT_Bucket* buckets = reinterpret_cast<DHT_Bucket*>(addr);
+        std::uninitialized_fill_n(buckets, capacity, DHT_Bucket{});
+        return buckets;
+    }
+
+    // Posición inicial de una clave con el reparto cíclico (key % size)
+    size_t homeSlot(int key, size_t capacity) const {
+        return (static_cast<size_t>(key) / size) % capacity;
+    }
+
+    // La clave cae fuera de la región de su dueño: con direccionamiento
+    // directo se solaparía con otra (la propiedad por bloques no desborda)
+    bool exceedsCapacity(int key) const {
+        return !directory->isBlocked() && static_cast<size_t>(key) / size >= local_capacity;
+    }
+
+    // Con GROW, una clave fuera de la región se aplaza en lugar de solaparse.
+    // Devuelve true si la escritura queda aplazada.
+    bool deferIfOverflow(int key, const GridCell& val) {
+        if (overflow->policy != OverflowPolicy::GROW || !exceedsCapacity(key)) return false;
+        deferWrite(key, val, static_cast<size_t>(key) / size + 1);
+        return true;
+    }
+
+    // Escritura pendiente hasta el siguiente growAtBoundary. needed_capacity
+    // pide crecer al menos hasta ese número de buckets (0: solo reintentar).
+    void deferWrite(int key, const GridCell& val, size_t needed_capacity) {
+        overflow->deferred.emplace_back(key, val);
+        overflow->needed_capacity = std::max(overflow->needed_capacity, needed_capacity);
+        overflow->total_deferred++;
+        metrics.deferred++;
+    }
+
+    // La ventana cambió (crecimiento): las tablas con vistas deben rehacerlas
+    virtual void onWindowReplaced() {}
+
+    // Solo en el modelo unificado puede una estrategia leer/escribir su propia
+    // ventana con accesos locales en lugar de RMA a sí misma
+    static bool queryUnifiedModel(MPI_Win w) {
+        int* model = nullptr;
+        int flag = 0;
+        MPI_Win_get_attr(w, MPI_WIN_MODEL, &model, &flag);
+        return flag && *model == MPI_WIN_UNIFIED;
+    }
+
+public:
     virtual ~DistributedHashTable() {
-        MPI_Win_free(&win);
-        MPI_Free_mem(local_buffer);
+        if (owns_window && win != MPI_WIN_NULL) {
+            MPI_Win_free(&win);
+            MPI_Free_mem(raw_buffer);
+        }
     }
 
     int getOwnerRank(int key) const {
-        // Distribución simple: cada proceso obtiene un bloque contiguo de celdas
-        return key % size;
+        // Distribución simple (key % size) salvo que se active la propiedad por
+        // bloques, en cuyo caso manda el directorio
+        return directory->ownerOf(key);
     }
 
     size_t getLocalOffset(int key) const {
-        // El offset local es simplemente key / size
-        // Esto garantiza que el offset siempre esté dentro de local_capacity
-        size_t offset = static_cast<size_t>(key) / size;
-        if (offset >= local_capacity) {
-            // Esto no debería pasar si local_capacity está bien calculado,
-            // pero por seguridad hacemos wrap-around
-            offset = offset % local_capacity;
-        }
-        return offset;
+        if (directory->isBlocked()) return directory->slotOf(key);
+
+        // El offset local es key / size; fuera de la capacidad da la vuelta
+        // (ver exceedsCapacity: con GROW esas escrituras se aplazan)
+        return homeSlot(key, local_capacity);
     }
 
     virtual void updateCell(int key, const GridCell& val) = 0;
     virtual GridCell getCell(int key) = 0;
     virtual std::string getStrategyName() const = 0;
 
-    virtual void advectStep() {
-        // Implementación vacía para benchmark
+    // true si getCell/updateCell pueden llamarse desde varios hilos a la vez.
+    // Las estrategias MPI asumen MPI_THREAD_SINGLE, así que por defecto no.
+    virtual bool isThreadSafe() const { return false; }
+
+    WindowView getWindowView() const {
+        return WindowView{win, local_buffer, local_capacity, rank, size, directory, overflow};
+    }
+
+    // Abrir/cerrar la época de acceso RMA que necesita la estrategia
+    // (lock_all en Lock-Free y Fine-Grained; Coarse-Grained bloquea por operación).
+    virtual void beginAccessEpoch() {}
+    virtual void endAccessEpoch() {}
+
+    // Preparar los buckets locales escritos por otra estrategia para que esta
+    // pueda leerlos (p. ej. recalcular checksums). Se llama sin época abierta.
+    virtual void adoptLocalBuckets() {}
+
+    // Límite entre pasos de simulación. Colectiva: todos los procesos la llaman.
+    virtual void stepBoundary() {}
+
+    // Lanza un MPI_Get por clave sin esperar. Válido dentro de una época
+    // lock_all (Lock-Free, Fine-Grained); otras estrategias lo redefinen.
+    virtual void startFetch(FetchBatch& batch) {
+        batch.buckets.resize(batch.keys.size());
+        for (size_t i = 0; i < batch.keys.size(); ++i) {
+            int key = batch.keys[i];
+            MPI_Get(&batch.buckets[i], sizeof(DHT_Bucket), MPI_BYTE,
+                    getOwnerRank(key), getLocalOffset(key) * sizeof(DHT_Bucket),
+                    sizeof(DHT_Bucket), MPI_BYTE, win);
+        }
+    }
+
+    virtual void completeFetch(FetchBatch& batch) {
+        if (!batch.keys.empty()) MPI_Win_flush_all(win);
     }
 
+    // false si el bucket no sirve (vacío, otra clave, inconsistente): el
+    // llamador debe recurrir a getCell
+    virtual bool decodeFetched(const DHT_Bucket& b, int key, GridCell& out) {
+        if (bucketState(b.control) != BUCKET_OCCUPIED || b.key != key) return false;
+        out = b.value;
+        return true;
+    }
+
+    const OwnershipDirectory& getDirectory() const { return *directory; }
+    OwnershipDirectory& getDirectory() { return *directory; }
+
+    // Activar la propiedad por bloques migrables. Debe llamarse en todos los
+    // procesos antes de insertar datos (el cálculo es determinista y local).
+    void enableBlockOwnership(int total_entries, int blocks_per_rank) {
+        if (win == MPI_WIN_NULL) return; // Sin ventana no hay nada que repartir
+        directory->enableBlocks(total_entries, blocks_per_rank, local_capacity);
+    }
+
+    // Carga masiva colectiva. Cada proceso aporta su lote de pares (clave, valor);
+    // un único MPI_Alltoallv los lleva a sus dueños y cada dueño construye sus
+    // buckets directamente en local_buffer (en paralelo), con la época RMA de la
+    // estrategia cerrada. Sustituye a un updateCell remoto por celda.
+    virtual void bulkLoad(const std::vector<std::pair<int, GridCell>>& entries) {
+        // 1. Empaquetar por proceso destino
+        std::vector<int> send_counts(size, 0), send_displs(size, 0);
+        for (const auto& e : entries) send_counts[getOwnerRank(e.first)]++;
+        for (int r = 1; r < size; ++r) send_displs[r] = send_displs[r - 1] + send_counts[r - 1];
+
+        std::vector<DHT_Bucket> send_buf(entries.size());
+        std::vector<int> fill = send_displs;
+        for (const auto& e : entries) {
+            DHT_Bucket& b = send_buf[fill[getOwnerRank(e.first)]++];
+            b.key = e.first;
+            b.value = e.second;
+            b.control = makeControl(BUCKET_OCCUPIED, 0);
+        }
+
+        // 2. Intercambio: primero los tamaños, luego los buckets
+        std::vector<int> recv_counts(size), recv_displs(size, 0);
+        MPI_Alltoall(send_counts.data(), 1, MPI_INT, recv_counts.data(), 1, MPI_INT,
+                     MPI_COMM_WORLD);
+        for (int r = 1; r < size; ++r) recv_displs[r] = recv_displs[r - 1] + recv_counts[r - 1];
+        std::vector<DHT_Bucket> recv_buf(recv_displs[size - 1] + recv_counts[size - 1]);
+
+        // Un bucket por elemento: los contadores no desbordan int con lotes grandes
+        MPI_Datatype bucket_type;
+        MPI_Type_contiguous(sizeof(DHT_Bucket), MPI_BYTE, &bucket_type);
+        MPI_Type_commit(&bucket_type);
+        MPI_Alltoallv(send_buf.data(), send_counts.data(), send_displs.data(), bucket_type,
+                      recv_buf.data(), recv_counts.data(), recv_displs.data(), bucket_type,
+                      MPI_COMM_WORLD);
+        MPI_Type_free(&bucket_type);
+
+        // Claves fuera de la región (reparto cíclico): con GROW se crece antes de
+        // construir; en modo caché pasan por updateCell en el siguiente límite
+        unsigned long long local_needed = 0, needed = 0;
+        for (const DHT_Bucket& b : recv_buf) {
+            if (exceedsCapacity(b.key)) {
+                local_needed = std::max<unsigned long long>(local_needed,
+                                                            static_cast<size_t>(b.key) / size + 1);
+            }
+        }
+        MPI_Allreduce(&local_needed, &needed, 1, MPI_UNSIGNED_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+        if (needed > 0 && overflow->policy == OverflowPolicy::GROW) {
+            size_t new_capacity = local_capacity * 2;
+            while (new_capacity < needed) new_capacity *= 2;
+            growWindow(new_capacity);
+        }
+
+        // 3. Construcción local fuera de la época de acceso
+        endAccessEpoch();
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, rank, 0, win);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < recv_buf.size(); ++i) {
+            if (exceedsCapacity(recv_buf[i].key)) continue; // Aplazadas abajo
+            local_buffer[getLocalOffset(recv_buf[i].key)] = recv_buf[i];
+        }
+        MPI_Win_unlock(rank, win);
+        for (const DHT_Bucket& b : recv_buf) {
+            if (exceedsCapacity(b.key)) deferWrite(b.key, b.value, 0);
+        }
+
+        adoptLocalBuckets(); // Checksums u otros metadatos propios de la estrategia
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        beginAccessEpoch();
+    }
+
+    // Migración colectiva de bloques. Todos los procesos deben pasar la misma
+    // lista (planificada con planMove sobre su copia del directorio).
+    // Los buckets se copian tal cual, así que los checksums siguen siendo válidos.
+    void migrateBlocks(const std::vector<BlockMove>& moves) {
+        if (moves.empty()) return;
+        size_t block_bytes = directory->getBlockSize() * sizeof(DHT_Bucket);
+
+        endAccessEpoch(); // Completa las operaciones RMA pendientes
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        std::vector<std::vector<DHT_Bucket>> buffers(moves.size());
+        std::vector<MPI_Request> requests;
+        for (size_t i = 0; i < moves.size(); ++i) {
+            const BlockMove& m = moves[i];
+            if (m.from_rank == m.to_rank) continue;
+            if (m.from_rank == rank) {
+                buffers[i].assign(local_buffer + m.from_slot,
+                                  local_buffer + m.from_slot + directory->getBlockSize());
+                requests.emplace_back();
+                MPI_Isend(buffers[i].data(), block_bytes, MPI_BYTE, m.to_rank,
+                          m.block, MPI_COMM_WORLD, &requests.back());
+            } else if (m.to_rank == rank) {
+                buffers[i].resize(directory->getBlockSize());
+                requests.emplace_back();
+                MPI_Irecv(buffers[i].data(), block_bytes, MPI_BYTE, m.from_rank,
+                          m.block, MPI_COMM_WORLD, &requests.back());
+            }
+        }
+        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+        // Escritura local en la ventana fuera de cualquier época de acceso
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, rank, 0, win);
+        for (size_t i = 0; i < moves.size(); ++i) {
+            const BlockMove& m = moves[i];
+            if (m.to_rank == rank) {
+                memcpy(local_buffer + m.to_slot, buffers[i].data(), block_bytes);
+            } else if (m.from_rank == rank) {
+                std::fill_n(local_buffer + m.from_slot, directory->getBlockSize(), DHT_Bucket{});
+            }
+        }
+        MPI_Win_unlock(rank, win);
+
+        for (const BlockMove& m : moves) directory->applyMove(m);
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        beginAccessEpoch();
+    }
+
+    // Crecimiento colectivo por doble reserva: ventana nueva de new_capacity
+    // buckets, rehash local de los ocupados (sondeo lineal si chocan, como en
+    // Coarse-Grained) y sustitución de la ventana antigua. Los buckets se
+    // copian enteros, así que los checksums siguen siendo válidos.
+    void growWindow(size_t new_capacity) {
+        endAccessEpoch(); // Completa las operaciones RMA pendientes
+        MPI_Barrier(MPI_COMM_WORLD);
+
+        void* new_raw = nullptr;
+        DHT_Bucket* new_buffer = allocateBuckets(new_capacity, new_raw);
+
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, rank, 0, win);
+        for (size_t i = 0; i < local_capacity; ++i) {
+            const DHT_Bucket& b = local_buffer[i];
+            if (bucketState(b.control) == BUCKET_EMPTY) continue;
+            size_t slot = homeSlot(b.key, new_capacity);
+            while (bucketState(new_buffer[slot].control) != BUCKET_EMPTY) {
+                slot = (slot + 1) % new_capacity;
+            }
+            new_buffer[slot] = b;
+            new_buffer[slot].control = makeControl(BUCKET_OCCUPIED, bucketTag(b.control));
+        }
+        MPI_Win_unlock(rank, win);
+
+        MPI_Win new_win;
+        MPI_Win_create(new_buffer, new_capacity * sizeof(DHT_Bucket), 1,
+                       MPI_INFO_NULL, MPI_COMM_WORLD, &new_win);
+        MPI_Win_free(&win);
+        MPI_Free_mem(raw_buffer);
+
+        win = new_win;
+        raw_buffer = new_raw;
+        local_buffer = new_buffer;
+        local_capacity = new_capacity;
+        unified_memory = queryUnifiedModel(win);
+        overflow->growths++;
+        onWindowReplaced();
+
+        MPI_Barrier(MPI_COMM_WORLD);
+        beginAccessEpoch();
+    }
+
+    // Ocupación de la memoria local de la tabla (para el informe de arranque)
+    struct MemoryUsage {
+        size_t bucket_bytes;
+        size_t capacity;   // Buckets reservados en este proceso
+        size_t occupied;   // Buckets con clave
+    };
+
+    virtual MemoryUsage getLocalMemoryUsage() const {
+        size_t occupied = 0;
+        #pragma omp parallel for reduction(+:occupied) schedule(static)
+        for (size_t i = 0; i < local_capacity; ++i) {
+            if (bucketState(local_buffer[i].control) != BUCKET_EMPTY) occupied++;
+        }
+        return MemoryUsage{sizeof(DHT_Bucket), local_capacity, occupied};
+    }
+
+    // Política ante desbordamiento (igual en todos los procesos). En modo caché
+    // cache_ways acota el conjunto de sondeo, y con él el coste de cada operación.
+    void setOverflowPolicy(OverflowPolicy policy, int cache_ways = 8) {
+        overflow->policy = policy;
+        overflow->cache_ways = cache_ways > 0 ? cache_ways : 1;
+    }
+
+    OverflowPolicy getOverflowPolicy() const { return overflow->policy; }
+    int getGrowthCount() const { return overflow->growths; }
+    // Incluye los de las vistas (p. ej. las estrategias de AdaptiveHashTable),
+    // que las métricas por objeto no recogen
+    long long getDeferredCount() const { return overflow->total_deferred; }
+    size_t getLocalCapacity() const { return local_capacity; }
+
+    // Límite de paso para la capacidad. Colectiva. Si algún proceso aplazó
+    // escrituras, con GROW se hace crecer la ventana (el doble, o más si hace
+    // falta) y después todos reescriben sus aplazadas. Con propiedad por
+    // bloques no se crece (los rangos de claves son fijos), pero las aplazadas
+    // (p. ej. locks no conseguidos en Fine-Grained) se reescriben igual.
+    // Devuelve true si creció.
+    bool growAtBoundary() {
+        if (win == MPI_WIN_NULL) return false;
+
+        // Una sola reducción por paso: basta el máximo para saber si alguien aplazó
+        unsigned long long local[2] = {overflow->deferred.size(), overflow->needed_capacity};
+        unsigned long long global[2];
+        MPI_Allreduce(local, global, 2, MPI_UNSIGNED_LONG_LONG, MPI_MAX, MPI_COMM_WORLD);
+        if (global[0] == 0) return false;
+
+        // local_capacity es igual en todos los procesos: la decisión también
+        bool grow = overflow->policy == OverflowPolicy::GROW && global[1] > local_capacity &&
+                    !directory->isBlocked();
+        if (grow) {
+            size_t new_capacity = local_capacity * 2;
+            while (new_capacity < global[1]) new_capacity *= 2;
+            growWindow(new_capacity);
+        }
+
+        std::vector<std::pair<int, GridCell>> pending;
+        pending.swap(overflow->deferred);
+        overflow->needed_capacity = 0;
+        for (const auto& e : pending) updateCell(e.first, e.second);
+        syncGhostCells();
+        return grow;
+    }
+
+    const DHT_Metrics& getMetrics() const { return metrics; }
+    void resetMetrics() { metrics = DHT_Metrics(); }
+
     virtual void syncGhostCells() {
         MPI_Win_flush_all(win); 
         MPI_Barrier(MPI_COMM_WORLD);
@@ -4,7 +4,7 @@
 #include "distributed_hash_table.hpp"
 #include <cstdint>
 
-class FineGrainedHashTable : public DistributedHashTable {
+class FineGrainedHashTable final : public DistributedHashTable {
 public:
     FineGrainedHashTable(int total_entries, int rank, int size)
         : DistributedHashTable(total_entries, rank, size) {
@@ -12,66 +12,81 @@ public:
         MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
     }
 
+    explicit FineGrainedHashTable(const WindowView& view)
+        : DistributedHashTable(view) {}
+
     ~FineGrainedHashTable() {
-        MPI_Win_unlock_all(win);
+        if (owns_window) MPI_Win_unlock_all(win);
     }
 
+    void beginAccessEpoch() override { MPI_Win_lock_all(MPI_MODE_NOCHECK, win); }
+    void endAccessEpoch() override { MPI_Win_unlock_all(win); }
+
     void updateCell(int key, const GridCell& val) override {
+        // Direccionamiento directo: una clave fuera de la región pisaría a otra
+        if (deferIfOverflow(key, val)) return;
+
         int target_rank = getOwnerRank(key);
         MPI_Aint base_offset = getLocalOffset(key);
         
-        // Offset del campo "status" dentro del struct Bucket (usado como lock)
-        MPI_Aint lock_offset = base_offset * sizeof(DHT_Bucket) + offsetof(DHT_Bucket, status); 
+        // La palabra de control (usada como lock) está al inicio del bucket
+        MPI_Aint lock_offset = base_offset * sizeof(DHT_Bucket) + offsetof(DHT_Bucket, control); 
         
-        // Usamos int porque status es int (4 bytes)
-        int lock_val = 2;    // 2 = locked by writer
-        int unlock_val = 0;  // 0 = empty/unlocked
-        int occupied_val = 1; // 1 = occupied but unlocked
-        int result_val = 0;
+        // CAS sobre la palabra completa (uint32_t: estado + tag)
+        // Primera suposición: sobrescritura de un bucket ya ocupado (el caso
+        // habitual tras el primer paso); si estaba vacío basta un CAS más
+        uint32_t expected = makeControl(BUCKET_OCCUPIED, 0);
+        uint32_t result_val = 0;
         bool locked = false;
         int max_attempts = 1000;
         int attempts = 0;
+        metrics.writes++;
+        double wait_start = MPI_Wtime();
 
         // 1. ADQUIRIR LOCK (SPINLOCK REMOTO)
         while (!locked && attempts < max_attempts) {
-            // Intentar cambiar de 0 o 1 a 2 (locked)
-            // Primero intentamos con 0 (vacío)
-            MPI_Compare_and_swap(&lock_val, &unlock_val, &result_val, 
-                                 MPI_INT, target_rank, lock_offset, win);
+            // Pasar de vacío/ocupado a bloqueado. Si el CAS falla, el valor
+            // devuelto es el nuevo esperado (salvo que otro escritor lo tenga)
+            uint32_t lock_val = makeControl(BUCKET_LOCKED, bucketTag(expected));
+            MPI_Compare_and_swap(&lock_val, &expected, &result_val, 
+                                 MPI_UINT32_T, target_rank, lock_offset, win);
             MPI_Win_flush(target_rank, win);
             
-            if (result_val == 0) {
+            if (result_val == expected) {
                 locked = true;
+            } else if (bucketState(result_val) == BUCKET_LOCKED) {
+                metrics.retries++; // Solo cuenta como contención otro escritor con el lock
             } else {
-                // Intentamos con 1 (ocupado pero no locked)
-                MPI_Compare_and_swap(&lock_val, &occupied_val, &result_val, 
-                                     MPI_INT, target_rank, lock_offset, win);
-                MPI_Win_flush(target_rank, win);
-                if (result_val == 1) locked = true;
+                expected = result_val; // Suposición errónea del estado: no es contención
             }
             attempts++;
         }
+        metrics.lock_wait_s += MPI_Wtime() - wait_start;
         
         if (!locked) {
-            // No pudimos adquirir el lock, abortamos esta operación
+            // No pudimos adquirir el lock: se reintenta en el siguiente límite
+            // de paso (growAtBoundary) en lugar de perder la escritura
+            deferWrite(key, val, 0);
             return;
         }
 
         // 2. SECCIÓN CRÍTICA (Escribir datos)
+        // Solo el payload (key + value): la palabra de control sigue siendo el lock
         DHT_Bucket b;
         b.key = key; 
         b.value = val; 
-        b.status = 1;  // Marcamos como ocupado (se sobrescribirá al final)
-        b.checksum = 0;
+        const MPI_Aint payload_offset = offsetof(DHT_Bucket, key);
+        const int payload_bytes = sizeof(DHT_Bucket) - payload_offset;
         
-        MPI_Put(&b, sizeof(DHT_Bucket), MPI_BYTE, 
-                target_rank, base_offset * sizeof(DHT_Bucket),
-                sizeof(DHT_Bucket), MPI_BYTE, win);
+        MPI_Put(reinterpret_cast<char*>(&b) + payload_offset, payload_bytes, MPI_BYTE, 
+                target_rank, base_offset * sizeof(DHT_Bucket) + payload_offset,
+                payload_bytes, MPI_BYTE, win);
         MPI_Win_flush(target_rank, win);
 
-        // 3. LIBERAR LOCK (poner status a 1 = ocupado pero libre)
-        MPI_Accumulate(&occupied_val, 1, MPI_INT, target_rank, lock_offset, 
-                       1, MPI_INT, MPI_REPLACE, win);
+        // 3. LIBERAR LOCK (ocupado pero libre)
+        uint32_t occupied_val = makeControl(BUCKET_OCCUPIED, 0);
+        MPI_Accumulate(&occupied_val, 1, MPI_UINT32_T, target_rank, lock_offset, 
+                       1, MPI_UINT32_T, MPI_REPLACE, win);
         MPI_Win_flush(target_rank, win);
     }
     
@@ -80,6 +95,7 @@ public:
     GridCell getCell(int key) override {
         int target_rank = getOwnerRank(key);
         MPI_Aint base_offset = getLocalOffset(key);
+        metrics.reads++;
         
         DHT_Bucket temp;
         
@@ -89,12 +105,18 @@ public:
                 sizeof(DHT_Bucket), MPI_BYTE, win);
         MPI_Win_flush(target_rank, win);
         
-        if (temp.status == 0 || temp.key != key) {
+        if (bucketState(temp.control) == BUCKET_EMPTY || temp.key != key) {
             return GridCell();
         }
         return temp.value;
     }
 
+    // Lotes de lectura: implementación base (MPI_Get + flush_all en la época lock_all)
+    void startFetch(FetchBatch& batch) override {
+        DistributedHashTable::startFetch(batch);
+        metrics.reads += batch.keys.size();
+    }
+
     std::string getStrategyName() const override {
         return "Fine-Grained (MPI_CAS)";
     }
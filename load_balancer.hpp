@@ -0,0 +1,141 @@
+#ifndef LOAD_BALANCER_HPP
+#define LOAD_BALANCER_HPP
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <mpi.h>
+#include "distributed_hash_table.hpp"
+
+// Balanceo dinámico de carga por migración de rangos de claves.
+//
+// El simulador informa del tiempo de trabajo de cada bloque que procesa. Cada
+// lb_interval pasos se suma el trabajo por bloque de todos los procesos; si el
+// proceso más cargado supera lb_imbalance_threshold veces la media, se mueven
+// sus bloques más adecuados a los procesos menos cargados. El plan se calcula
+// igual en todos los procesos (mismos datos de entrada), así que basta con
+// aplicarlo colectivamente con migrateBlocks.
+class LoadBalancer {
+private:
+    DistributedHashTable& table;
+    SimulationParams params;
+    int rank, size;
+
+    std::vector<double> block_work;  // Trabajo local acumulado por bloque (s)
+    int steps_in_window = 0;
+
+    // Varianza entre procesos del trabajo de cálculo por paso (química de los
+    // bloques, sin halos ni esperas) antes de la última migración
+    bool migration_pending_report = false;
+    double variance_before = 0.0;
+
+public:
+    LoadBalancer(DistributedHashTable& table, const SimulationParams& params,
+                 int rank, int size)
+        : table(table), params(params), rank(rank), size(size),
+          block_work(table.getDirectory().getNumBlocks(), 0.0) {}
+
+    void recordBlockWork(int block, double seconds) {
+        block_work[block] += seconds;
+    }
+
+    // Colectiva: llamar en todos los procesos al final de cada paso
+    void endStep(int step) {
+        steps_in_window++;
+        if (steps_in_window < params.lb_interval) return;
+
+        // 1. Trabajo global por bloque y por proceso
+        OwnershipDirectory& dir = table.getDirectory();
+        int num_blocks = dir.getNumBlocks();
+        std::vector<double> global_work(num_blocks);
+        MPI_Allreduce(block_work.data(), global_work.data(), num_blocks,
+                      MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+        std::vector<double> loads(size, 0.0);
+        for (int b = 0; b < num_blocks; ++b) loads[dir.blockOwner(b)] += global_work[b];
+
+        // 2. Varianza entre procesos del trabajo de cálculo por paso
+        std::vector<double> work_per_step(loads);
+        for (double& w : work_per_step) w /= steps_in_window;
+        double variance = computeVariance(work_per_step);
+
+        std::fill(block_work.begin(), block_work.end(), 0.0);
+        steps_in_window = 0;
+
+        if (migration_pending_report) {
+            migration_pending_report = false;
+            if (rank == 0) {
+                std::cout << "[LoadBalancer] per-rank compute-work variance after migration: "
+                          << variance_before * 1e6 << " -> " << variance * 1e6
+                          << " ms^2" << std::endl;
+            }
+        }
+
+        double mean_load = 0.0;
+        for (double l : loads) mean_load += l;
+        mean_load /= size;
+        double max_load = *std::max_element(loads.begin(), loads.end());
+        if (mean_load <= 0.0 || max_load <= params.lb_imbalance_threshold * mean_load) return;
+
+        // 3. Plan voraz: del más cargado al menos cargado, el bloque que más
+        //    reduzca el máximo de ambos
+        std::vector<BlockMove> moves;
+        std::vector<bool> moved(num_blocks, false);
+        for (int m = 0; m < params.lb_max_moves; ++m) {
+            int src = std::max_element(loads.begin(), loads.end()) - loads.begin();
+            int dst = std::min_element(loads.begin(), loads.end()) - loads.begin();
+            if (loads[src] <= params.lb_imbalance_threshold * mean_load) break;
+            if (!dir.hasFreeSlot(dst)) break;
+
+            std::vector<int> owned = dir.blocksOwnedBy(src);
+            if (owned.size() <= 1) break;
+
+            int best = -1;
+            double best_peak = loads[src];
+            for (int b : owned) {
+                if (moved[b]) continue;
+                double peak = std::max(loads[src] - global_work[b], loads[dst] + global_work[b]);
+                if (peak < best_peak) {
+                    best_peak = peak;
+                    best = b;
+                }
+            }
+            if (best < 0) break;
+
+            moves.push_back(dir.planMove(best, dst));
+            moved[best] = true;
+            loads[src] -= global_work[best];
+            loads[dst] += global_work[best];
+        }
+        if (moves.empty()) return;
+
+        double predicted_max = *std::max_element(loads.begin(), loads.end());
+        if (rank == 0) {
+            std::cout << "[LoadBalancer] step " << step << ": imbalance "
+                      << max_load / mean_load << " -> predicted "
+                      << predicted_max / mean_load << ", migrating "
+                      << moves.size() << " block(s) of " << dir.getBlockSize() << " keys:";
+            for (const BlockMove& mv : moves) {
+                std::cout << " " << mv.block << "(" << mv.from_rank << "->" << mv.to_rank << ")";
+            }
+            std::cout << std::endl;
+        }
+
+        // 4. Migración colectiva (datos + directorio)
+        table.migrateBlocks(moves);
+        variance_before = variance;
+        migration_pending_report = true;
+    }
+
+private:
+    static double computeVariance(const std::vector<double>& values) {
+        double mean = 0.0;
+        for (double v : values) mean += v;
+        mean /= values.size();
+        double var = 0.0;
+        for (double v : values) var += (v - mean) * (v - mean);
+        return var / values.size();
+    }
+};
+
+#endif // LOAD_BALANCER_HPP
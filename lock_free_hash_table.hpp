@@ -2,8 +2,9 @@
 #define LOCK_FREE_HASH_TABLE_HPP
 
 #include "distributed_hash_table.hpp"
+#include <cstdint>
 
-class LockFreeHashTable : public DistributedHashTable {
+class LockFreeHashTable final : public DistributedHashTable {
 public:
     LockFreeHashTable(int total_entries, int rank, int size)
         : DistributedHashTable(total_entries, rank, size) {
@@ -14,34 +15,75 @@ public:
         MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
     }
 
+    // Vista sobre una ventana ajena: la época la abre quien la gestiona
+    explicit LockFreeHashTable(const WindowView& view)
+        : DistributedHashTable(view) {}
+
     ~LockFreeHashTable() {
-        MPI_Win_unlock_all(win);
+        if (owns_window) MPI_Win_unlock_all(win);
+    }
+
+    void beginAccessEpoch() override { MPI_Win_lock_all(MPI_MODE_NOCHECK, win); }
+    void endAccessEpoch() override { MPI_Win_unlock_all(win); }
+
+    // Otras estrategias no mantienen el checksum: recalcularlo en los buckets locales
+    void adoptLocalBuckets() override {
+        MPI_Win_lock(MPI_LOCK_EXCLUSIVE, rank, 0, win);
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < local_capacity; ++i) {
+            if (bucketState(local_buffer[i].control) != BUCKET_EMPTY) {
+                local_buffer[i].control = makeControl(BUCKET_OCCUPIED,
+                                                      calculateChecksum(local_buffer[i]));
+            }
+        }
+        MPI_Win_unlock(rank, win);
     }
 
     // Función auxiliar de Checksum (Hash simple para integridad)
     // "The origin process is responsible for calculating a checksum" [cite: 245]
-    unsigned int calculateChecksum(const DHT_Bucket& b) {
+    // Se guarda como tag de la palabra de control (30 bits bajos del hash).
+    unsigned int calculateChecksum(const DHT_Bucket& b) const {
         unsigned int hash = 0;
-        // Checksum de la clave y los datos (concentraciones)
-        hash ^= std::hash<int>{}(b.key);
+        // Checksum de la clave y los datos (concentraciones). Se mezclan los bits
+        // de cada double directamente: std::hash<double> llama a _Hash_bytes
+        // fuera de línea y no se puede inlinear en el bucle interno.
+        hash ^= static_cast<unsigned int>(b.key);
         for(double c : b.value.concentrations) {
-            hash ^= std::hash<double>{}(c) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+            uint64_t bits;
+            std::memcpy(&bits, &c, sizeof(bits));
+            unsigned int h = static_cast<unsigned int>(bits ^ (bits >> 32));
+            hash ^= h + 0x9e3779b9 + (hash << 6) + (hash >> 2);
         }
         return hash;
     }
 
+    bool checksumMatches(const DHT_Bucket& b) const {
+        return b.control == makeControl(BUCKET_OCCUPIED, calculateChecksum(b));
+    }
+
     void updateCell(int key, const GridCell& val) override {
+        // Direccionamiento directo: una clave fuera de la región pisaría a otra
+        if (deferIfOverflow(key, val)) return;
+
         int target_rank = getOwnerRank(key);
         MPI_Aint target_offset = getLocalOffset(key);
 
+        metrics.writes++;
+
         DHT_Bucket bucket;
         bucket.key = key;
         bucket.value = val;
-        bucket.status = 1; // Ocupado
         
-        // 1. CALCULAR CHECKSUM
+        // 1. CALCULAR CHECKSUM (Ocupado + checksum en la palabra de control)
         // "Appending it to the bucket data" [cite: 245]
-        bucket.checksum = calculateChecksum(bucket);
+        bucket.control = makeControl(BUCKET_OCCUPIED, calculateChecksum(bucket));
+
+        // Ruta local: store directo en la ventana (el lector valida con checksum,
+        // igual que frente a un MPI_Put concurrente)
+        if (target_rank == rank && unified_memory) {
+            local_buffer[target_offset] = bucket;
+            return;
+        }
 
         // 2. ESCRITURA "OPTIMISTA" (Sin Lock individual)
         // Usamos MPI_Put directamente. Si hay colisión de escritura, el checksum del lector fallará.
@@ -60,23 +102,26 @@ public:
         DHT_Bucket temp;
         int attempts = 0;
         const int MAX_ATTEMPTS = 10; // Límite de reintentos por consistencia
+        metrics.reads++;
 
         while (attempts < MAX_ATTEMPTS) {
-            // 1. LEER (READ)
-            MPI_Get(&temp, sizeof(DHT_Bucket), MPI_BYTE,
-                    target_rank, target_offset * sizeof(DHT_Bucket),
-                    sizeof(DHT_Bucket), MPI_BYTE, win);
-            
-            MPI_Win_flush(target_rank, win); // Esperar a recibir datos
+            // 1. LEER (READ): copia local si el bucket es nuestro, si no MPI_Get
+            if (target_rank == rank && unified_memory) {
+                temp = local_buffer[target_offset];
+            } else {
+                MPI_Get(&temp, sizeof(DHT_Bucket), MPI_BYTE,
+                        target_rank, target_offset * sizeof(DHT_Bucket),
+                        sizeof(DHT_Bucket), MPI_BYTE, win);
+                
+                MPI_Win_flush(target_rank, win); // Esperar a recibir datos
+            }
 
             // Si está vacío, no hay nada que validar
-            if (temp.status == 0) return GridCell();
+            if (bucketState(temp.control) == BUCKET_EMPTY) return GridCell();
 
             // 2. VALIDAR CHECKSUM
             // "Recalculates the checksum... If equal... returned" [cite: 246-247]
-            unsigned int local_calc = calculateChecksum(temp);
-            
-            if (local_calc == temp.checksum) {
+            if (checksumMatches(temp)) {
                 if (temp.key == key) return temp.value;
                 // Colisión de Hash (Linear Probing) - no implementado full en versión simple
                 // para mantener el benchmark enfocado en la latencia de red/consistencia.
@@ -86,6 +131,7 @@ public:
             // 3. FALLO DE CONSISTENCIA -> REINTENTAR
             // "In the event of a mismatch, the MPI_Get operation... is repeated" [cite: 248]
             attempts++;
+            metrics.retries++;
             // (Opcional) Pequeño backoff para dejar que el escritor termine
         }
         
@@ -93,6 +139,31 @@ public:
         return GridCell(); 
     }
 
+    void startFetch(FetchBatch& batch) override {
+        DistributedHashTable::startFetch(batch);
+        metrics.reads += batch.keys.size();
+    }
+
+    // Mismo criterio que getCell: solo se acepta si el checksum coincide
+    bool decodeFetched(const DHT_Bucket& b, int key, GridCell& out) override {
+        if (bucketState(b.control) == BUCKET_EMPTY || b.key != key) return false;
+        if (!checksumMatches(b)) {
+            metrics.retries++;
+            return false;
+        }
+        out = b.value;
+        return true;
+    }
+
+    // Con la ruta local, sincronizar la copia privada y la pública de la
+    // ventana antes y después de la barrera
+    void syncGhostCells() override {
+        MPI_Win_sync(win);
+        MPI_Win_flush_all(win);
+        MPI_Barrier(MPI_COMM_WORLD);
+        MPI_Win_sync(win);
+    }
+
     std::string getStrategyName() const override {
         return "Lock-Free (Optimistic Checksum)";
     }
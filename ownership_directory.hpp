@@ -0,0 +1,117 @@
+#ifndef OWNERSHIP_DIRECTORY_HPP
+#define OWNERSHIP_DIRECTORY_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Movimiento de un bloque de claves entre procesos
+struct BlockMove {
+    int block;
+    int from_rank;
+    int to_rank;
+    size_t from_slot;  // Primer bucket del bloque en el buffer de origen
+    size_t to_slot;    // Primer bucket reservado en el buffer de destino
+};
+
+// Directorio de propiedad de claves.
+//
+// Por defecto reproduce la distribución estática original (key % size).
+// En modo por bloques, el espacio de claves se divide en rangos contiguos de
+// block_size claves; cada bloque tiene un dueño y una posición en su buffer
+// local, y puede migrar a otro proceso en un límite de paso. Cada proceso
+// guarda una copia completa (caché) del directorio: los cambios son colectivos
+// y deterministas, así que todas las copias se actualizan a la vez sin mensajes.
+class OwnershipDirectory {
+private:
+    int size;
+    bool blocked = false;
+    int block_size = 1;
+    int num_blocks = 0;
+    std::vector<int> block_owner;               // bloque -> rango dueño
+    std::vector<size_t> block_slot;             // bloque -> primer bucket en el dueño
+    std::vector<std::vector<size_t>> free_slots; // rango -> huecos de bloque libres
+
+public:
+    explicit OwnershipDirectory(int size) : size(size) {}
+
+    // Pasar a propiedad por bloques contiguos (antes de insertar datos).
+    // Cada proceso recibe blocks_per_rank bloques consecutivos; el resto de su
+    // capacidad local queda como huecos para bloques migrados.
+    void enableBlocks(int total_entries, int blocks_per_rank, size_t local_capacity) {
+        int total_blocks = size * blocks_per_rank;
+        block_size = (total_entries + total_blocks - 1) / total_blocks;
+        if (block_size < 1) block_size = 1;
+        num_blocks = (total_entries + block_size - 1) / block_size;
+
+        block_owner.resize(num_blocks);
+        block_slot.resize(num_blocks);
+        size_t slots_per_rank = local_capacity / block_size;
+
+        std::vector<size_t> used(size, 0);
+        for (int b = 0; b < num_blocks; ++b) {
+            int owner = b / blocks_per_rank;
+            block_owner[b] = owner;
+            block_slot[b] = used[owner] * block_size;
+            used[owner]++;
+        }
+
+        free_slots.assign(size, std::vector<size_t>());
+        for (int r = 0; r < size; ++r) {
+            // Orden inverso para que pop_back entregue primero los huecos bajos
+            for (size_t s = slots_per_rank; s > used[r]; --s) {
+                free_slots[r].push_back((s - 1) * block_size);
+            }
+        }
+        blocked = true;
+    }
+
+    bool isBlocked() const { return blocked; }
+    int getBlockSize() const { return block_size; }
+    int getNumBlocks() const { return num_blocks; }
+
+    int blockOf(int key) const { return key / block_size; }
+    int blockStart(int block) const { return block * block_size; }
+    int blockOwner(int block) const { return block_owner[block]; }
+    size_t blockSlot(int block) const { return block_slot[block]; }
+
+    int ownerOf(int key) const {
+        if (!blocked) return key % size;
+        return block_owner[key / block_size];
+    }
+
+    // Solo válido en modo por bloques
+    size_t slotOf(int key) const {
+        return block_slot[key / block_size] + (key % block_size);
+    }
+
+    std::vector<int> blocksOwnedBy(int r) const {
+        std::vector<int> owned;
+        for (int b = 0; b < num_blocks; ++b) {
+            if (block_owner[b] == r) owned.push_back(b);
+        }
+        return owned;
+    }
+
+    bool hasFreeSlot(int r) const { return !free_slots[r].empty(); }
+
+    // Reserva el hueco de destino. El hueco de origen no se libera hasta
+    // applyMove, así ningún hueco se reutiliza dentro de la misma migración.
+    BlockMove planMove(int block, int to_rank) {
+        BlockMove move;
+        move.block = block;
+        move.from_rank = block_owner[block];
+        move.to_rank = to_rank;
+        move.from_slot = block_slot[block];
+        move.to_slot = free_slots[to_rank].back();
+        free_slots[to_rank].pop_back();
+        return move;
+    }
+
+    void applyMove(const BlockMove& move) {
+        free_slots[move.from_rank].push_back(move.from_slot);
+        block_owner[move.block] = move.to_rank;
+        block_slot[move.block] = move.to_slot;
+    }
+};
+
+#endif // OWNERSHIP_DIRECTORY_HPP
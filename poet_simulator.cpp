@@ -1,5 +1,6 @@
 #include <chrono>
 #include <iostream>
+#include <algorithm>
 #include <memory>
 #include <utility>
 #include <mpi.h>
@@ -11,21 +12,73 @@
 #include "lock_free_hash_table.hpp"
 #include "coarse_grained_hash_table.hpp"
 #include "fine_grained_hash_table.hpp"
+#include "shared_memory_hash_table.hpp"
+#include "adaptive_hash_table.hpp"
+#include "load_balancer.hpp"
+#include "reaction_kernel.hpp"
+#include "advection.hpp"
+#include "capacity_benchmark.hpp"
 
+// Rango contiguo de celdas asignado a este proceso
+struct CellRange {
+    int start_id, end_id;
+    int block; // Bloque del directorio, o -1 sin propiedad por bloques
+};
+
+// El simulador se instancia por estrategia concreta (todas son final), así que
+// getCell/updateCell en el bucle interno se resuelven en compilación y pueden
+// inlinearse. DistributedHashTable sigue siendo la interfaz común (tabla
+// adaptativa, balanceador, benchmarks).
+template <class Table>
 class POETSimulator {
 private:
-    std::unique_ptr<DistributedHashTable> hash_table;
+    std::unique_ptr<Table> hash_table;
+    std::unique_ptr<LoadBalancer> balancer;
+    std::unique_ptr<ReactionKernel> kernel;
     SimulationParams params;
     int rank, size;
+
+    // Tiempo acumulado por fase: lecturas + difusión, química, escrituras
+    double time_transport = 0.0, time_chemistry = 0.0, time_write = 0.0;
+    // Advección: cálculo, y lectura de teselas + escritura; volumen leído
+    double time_advect = 0.0, time_advect_comm = 0.0;
+    double advect_keys = 0.0, advect_remote_keys = 0.0;
+    int advect_substeps = 0;
+
+    // Referencia para la fracción de solapamiento: tiempo del mismo lote de
+    // halos leído de forma bloqueante (se recalibra si cambia el lote o la estrategia)
+    double halo_blocking_time = -1.0;
+    size_t halo_calibrated_keys = 0;
+    std::string halo_calibrated_strategy;
     
 public:
-    POETSimulator(std::unique_ptr<DistributedHashTable>&& table, 
-                  const SimulationParams& params, int rank, int size)
-        : hash_table(std::move(table)), params(params), rank(rank), size(size) {}
+    // Sin kernel explícito se usa la química original (A + B -> C, Euler explícito)
+    POETSimulator(std::unique_ptr<Table>&& table, 
+                  const SimulationParams& params, int rank, int size,
+                  std::unique_ptr<ReactionKernel> reaction_kernel = nullptr)
+        : hash_table(std::move(table)), kernel(std::move(reaction_kernel)),
+          params(params), rank(rank), size(size) {
+        if (!kernel) {
+            kernel = std::make_unique<ExplicitReactionKernel>(
+                ReactionNetwork::defaultNetwork(params.num_species));
+        }
+    }
     
     void runSimulation() {
+        // Con balanceo o solapamiento, cada proceso calcula las celdas de los
+        // bloques que posee (sin propiedad por bloques no hay celdas interiores)
+        if (params.load_balancing || params.overlap_comm) {
+            hash_table->enableBlockOwnership(params.grid_x * params.grid_y,
+                                             params.lb_blocks_per_rank);
+            if (params.load_balancing && hash_table->getDirectory().isBlocked()) {
+                balancer = std::make_unique<LoadBalancer>(*hash_table, params, rank, size);
+            }
+        }
+
         // Inicializar celdas con valores de concentración
         initializeCells();
+        reportMemoryUsage();
+        hash_table->stepBoundary();
         
         auto start_time = std::chrono::high_resolution_clock::now();
         
@@ -34,16 +87,25 @@ public:
                 std::cout << "Step " << step << " running..." << std::endl;
             }
             
-            // 1. Advección
-            // NOTA: En la implementación "Lite" del benchmark, nos saltamos la física de fluidos
-            // para centrarnos en el estrés de lectura/escritura de la DHT.
-            // hash_table->advectStep(); 
+            // 1. Advección (lee el estado que dejó el paso anterior)
+            if (params.advection) {
+                hash_table->syncGhostCells();
+                advectStep();
+            }
             
             // 2. Sincronización
             hash_table->syncGhostCells();
             
             // 3. Reacciones (Aquí ocurre la carga pesada sobre la DHT)
-            simulateReactions();
+            simulateReactions(step);
+
+            // 4. Límite de paso (la tabla adaptativa decide aquí si cambia de
+            //    protocolo; si hubo escrituras aplazadas, la tabla crece aquí)
+            hash_table->stepBoundary();
+            hash_table->growAtBoundary();
+
+            // 5. Balanceo de carga (migración colectiva de bloques si hace falta)
+            if (balancer) balancer->endStep(step);
         }
         
         auto end_time = std::chrono::high_resolution_clock::now();
@@ -55,89 +117,432 @@ public:
                       << " completed in " << duration.count() 
                       << " ms" << std::endl;
         }
+        reportPhaseTimes();
     }
     
 private:
-    // Inicializar concentraciones con valores no-cero
+    // Desglose por fase (máximo entre procesos): comunicación frente a cálculo
+    void reportPhaseTimes() {
+        double local[5] = {time_transport, time_chemistry, time_write,
+                           time_advect, time_advect_comm};
+        double global[5];
+        MPI_Reduce(local, global, 5, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        double keys_local[2] = {advect_keys, advect_remote_keys};
+        double keys[2];
+        MPI_Reduce(keys_local, keys, 2, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        long long truncated_local = kernel->getTruncatedCount(), truncated = 0;
+        MPI_Reduce(&truncated_local, &truncated, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            if (params.advection) {
+                double per_step = params.steps > 0 ? 1.0 / params.steps : 0.0;
+                std::cout << "Advection (order " << (params.advection_order == 1 ? 1 : 2)
+                          << ", " << advect_substeps << " substep(s)): compute "
+                          << global[3] * 1000.0 << " ms, tile fetch + write "
+                          << global[4] * 1000.0 << " ms | "
+                          << (long long)(keys[0] * per_step) << " keys/step read, "
+                          << keys[1] * per_step * sizeof(DHT_Bucket) / (1024.0 * 1024.0)
+                          << " MB/step remote" << std::endl;
+            }
+            std::cout << "Phases (max/rank): DHT read + transport " << global[0] * 1000.0
+                      << " ms, chemistry [" << kernel->getName() << "] "
+                      << global[1] * 1000.0 << " ms, DHT write " << global[2] * 1000.0
+                      << " ms" << std::endl;
+            if (truncated > 0) {
+                std::cout << "WARNING: " << truncated << " cell integrations hit the step limit "
+                          << "before reaching dt (tolerance not met)" << std::endl;
+            }
+        }
+    }
+
+    // Celdas que calcula este proceso: un rango fijo, o los bloques que posee
+    // según el directorio si el balanceo de carga está activo
+    std::vector<CellRange> getComputeRanges() const {
+        std::vector<CellRange> ranges;
+        const OwnershipDirectory& dir = hash_table->getDirectory();
+        if (dir.isBlocked()) {
+            int total_cells = params.grid_x * params.grid_y;
+            for (int b : dir.blocksOwnedBy(rank)) {
+                int start_id = dir.blockStart(b);
+                int end_id = std::min(start_id + dir.getBlockSize(), total_cells);
+                ranges.push_back({start_id, end_id, b});
+            }
+        } else {
+            int cells_per_rank = (params.grid_x * params.grid_y) / size;
+            int start_id = rank * cells_per_rank;
+            ranges.push_back({start_id, start_id + cells_per_rank, -1});
+        }
+        return ranges;
+    }
+
+    // Inicializar concentraciones con valores no-cero. Las celdas se cargan en
+    // bloque (un MPI_Alltoallv) en lugar de un updateCell remoto por celda.
     void initializeCells() {
-        int cells_per_rank = (params.grid_x * params.grid_y) / size;
-        int start_id = rank * cells_per_rank;
-        int end_id = start_id + cells_per_rank;
-
-        for (int cell_id = start_id; cell_id < end_id; ++cell_id) {
-            GridCell cell;
-            // Inicializar con gradiente para simular condiciones iniciales
-            double x = (cell_id % params.grid_x) / (double)params.grid_x;
-            double y = (cell_id / params.grid_x) / (double)params.grid_y;
-            
-            cell.concentrations[0] = 1.0 - x;        // Especie A: gradiente horizontal
-            cell.concentrations[1] = y;              // Especie B: gradiente vertical
-            cell.concentrations[2] = 0.0;            // Especie C: producto
-            cell.concentrations[3] = 0.5;            // Especie D: constante
-            cell.concentrations[4] = (x + y) / 2.0;  // Especie E: mixto
-            
-            hash_table->updateCell(cell_id, cell);
+        double t0 = MPI_Wtime();
+
+        std::vector<CellRange> ranges = getComputeRanges();
+        size_t total = 0;
+        for (const CellRange& range : ranges) total += range.end_id - range.start_id;
+
+        std::vector<std::pair<int, GridCell>> batch(total);
+        size_t base = 0;
+        for (const CellRange& range : ranges) {
+            int count = range.end_id - range.start_id;
+            #pragma omp parallel for schedule(static)
+            for (int i = 0; i < count; ++i) {
+                int cell_id = range.start_id + i;
+                batch[base + i] = std::make_pair(cell_id, makeInitialCell(cell_id));
+            }
+            base += count;
         }
+
+        hash_table->bulkLoad(batch);
         hash_table->syncGhostCells();
+
+        double elapsed = MPI_Wtime() - t0;
+        double max_elapsed;
+        MPI_Reduce(&elapsed, &max_elapsed, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "Initialization (bulk load): " << max_elapsed * 1000.0
+                      << " ms" << std::endl;
+        }
     }
 
-    void simulateReactions() {
-        int cells_per_rank = (params.grid_x * params.grid_y) / size;
-        int start_id = rank * cells_per_rank;
-        int end_id = start_id + cells_per_rank;
+    // Memoria de la tabla tras la carga: tamaño de bucket, bytes por proceso y
+    // factor de carga global
+    void reportMemoryUsage() {
+        auto usage = hash_table->getLocalMemoryUsage();
+        double local_bytes = (double)usage.capacity * usage.bucket_bytes;
+        double sums[3] = {local_bytes, (double)usage.capacity, (double)usage.occupied};
+        double totals[3], max_bytes;
+        MPI_Reduce(sums, totals, 3, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        MPI_Reduce(&local_bytes, &max_bytes, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            std::cout << "Memory: bucket " << usage.bucket_bytes << " B (align "
+                      << DHT_BUCKET_ALIGN << ") | " << (long long)(totals[1] / size)
+                      << " buckets/rank, max " << max_bytes / (1024.0 * 1024.0)
+                      << " MB/rank, " << totals[0] / (1024.0 * 1024.0)
+                      << " MB total | load factor "
+                      << (totals[1] > 0 ? totals[2] / totals[1] * 100.0 : 0.0)
+                      << "%" << std::endl;
+        }
+    }
 
-        double diffusion_coef = 0.1;
-        double reaction_rate = 0.01;
+    GridCell makeInitialCell(int cell_id) const {
+        GridCell cell;
+        // Inicializar con gradiente para simular condiciones iniciales
+        double x = (cell_id % params.grid_x) / (double)params.grid_x;
+        double y = (cell_id / params.grid_x) / (double)params.grid_y;
+        
+        cell.concentrations[0] = 1.0 - x;        // Especie A: gradiente horizontal
+        cell.concentrations[1] = y;              // Especie B: gradiente vertical
+        cell.concentrations[2] = 0.0;            // Especie C: producto
+        cell.concentrations[3] = 0.5;            // Especie D: constante
+        cell.concentrations[4] = (x + y) / 2.0;  // Especie E: mixto
+        return cell;
+    }
 
-        for (int cell_id = start_id; cell_id < end_id; ++cell_id) {
-            // Coordenadas 2D de la celda
-            int x = cell_id % params.grid_x;
-            int y = cell_id / params.grid_x;
-            
-            // A. READ celda actual
-            auto cell = hash_table->getCell(cell_id);
-            
-            // B. READ celdas vecinas (acceso potencialmente remoto - aumenta contención)
-            GridCell left, right, up, down;
-            
-            // Condiciones de borde periódicas
-            int left_id  = (x > 0) ? cell_id - 1 : cell_id + params.grid_x - 1;
-            int right_id = (x < params.grid_x - 1) ? cell_id + 1 : cell_id - params.grid_x + 1;
-            int up_id    = (y > 0) ? cell_id - params.grid_x : cell_id + (params.grid_y - 1) * params.grid_x;
-            int down_id  = (y < params.grid_y - 1) ? cell_id + params.grid_x : cell_id - (params.grid_y - 1) * params.grid_x;
-            
-            left  = hash_table->getCell(left_id);
-            right = hash_table->getCell(right_id);
-            up    = hash_table->getCell(up_id);
-            down  = hash_table->getCell(down_id);
-            
-            // C. DIFUSIÓN (Laplaciano discreto)
-            for (int s = 0; s < params.num_species; ++s) {
-                double laplacian = left.concentrations[s] + right.concentrations[s] 
-                                 + up.concentrations[s] + down.concentrations[s] 
-                                 - 4.0 * cell.concentrations[s];
-                cell.concentrations[s] += diffusion_coef * laplacian * params.dt;
+    // Rangos contiguos fusionados (los bloques adyacentes forman una sola tesela)
+    std::vector<CellRange> getMergedRanges() const {
+        std::vector<CellRange> ranges = getComputeRanges();
+        std::sort(ranges.begin(), ranges.end(),
+                  [](const CellRange& a, const CellRange& b) { return a.start_id < b.start_id; });
+        std::vector<CellRange> merged;
+        for (const CellRange& range : ranges) {
+            if (!merged.empty() && merged.back().end_id == range.start_id) {
+                merged.back().end_id = range.end_id;
+            } else {
+                merged.push_back({range.start_id, range.end_id, -1});
+            }
+        }
+        return merged;
+    }
+
+    // Advección sobre teselas de filas completas: una lectura en lote de cada
+    // tesela con su halo, todos los sub-pasos CFL en local y escritura de las
+    // celdas propias. Colectiva: nadie escribe hasta que todos han leído.
+    void advectStep() {
+        const int nx = params.grid_x, ny = params.grid_y, ns = params.num_species;
+        UpwindAdvection advection(params);
+        const int substeps = UpwindAdvection::substepsFor(params);
+        const int halo_rows = advection.haloRows(substeps);
+        advect_substeps = substeps;
+
+        // 1. Teselas: filas que tocan el rango más halo_rows por cada lado
+        std::vector<CellRange> ranges = getMergedRanges();
+        std::vector<AdvectionTile> tiles;
+        FetchBatch batch;
+        for (const CellRange& range : ranges) {
+            int first_row = range.start_id / nx - halo_rows;
+            int last_row = (range.end_id - 1) / nx + halo_rows;
+            tiles.emplace_back(ns, nx, first_row, last_row - first_row + 1);
+            for (int y = first_row; y <= last_row; ++y) {
+                int wrapped = ((y % ny) + ny) % ny;
+                for (int x = 0; x < nx; ++x) {
+                    int key = wrapped * nx + x;
+                    batch.keys.push_back(key);
+                    if (hash_table->getOwnerRank(key) != rank) advect_remote_keys++;
+                }
+            }
+        }
+        advect_keys += batch.keys.size();
+
+        // 2. Lectura en lote y desempaquetado a SoA
+        double t0 = MPI_Wtime();
+        hash_table->startFetch(batch);
+        hash_table->completeFetch(batch);
+        size_t base = 0;
+        for (AdvectionTile& tile : tiles) {
+            long count = static_cast<long>(tile.getRows()) * nx;
+            #pragma omp parallel for schedule(static) if(hash_table->isThreadSafe())
+            for (long i = 0; i < count; ++i) {
+                int key = batch.keys[base + i];
+                GridCell cell;
+                if (!hash_table->decodeFetched(batch.buckets[base + i], key, cell)) {
+                    cell = hash_table->getCell(key);
+                }
+                for (int s = 0; s < ns; ++s) tile.row(s, i / nx)[i % nx] = cell.concentrations[s];
+            }
+            base += count;
+        }
+
+        // 3. Advección local (sin comunicación entre sub-pasos)
+        double t1 = MPI_Wtime();
+        for (AdvectionTile& tile : tiles) advection.advect(tile, params.dt, substeps);
+        double t2 = MPI_Wtime();
+
+        // 4. Escritura de las celdas propias, cuando todos han terminado de leer
+        MPI_Barrier(MPI_COMM_WORLD);
+        for (size_t t = 0; t < ranges.size(); ++t) {
+            AdvectionTile& tile = tiles[t];
+            int start_id = ranges[t].start_id, end_id = ranges[t].end_id;
+            #pragma omp parallel for schedule(static) if(hash_table->isThreadSafe())
+            for (int cell_id = start_id; cell_id < end_id; ++cell_id) {
+                int r = cell_id / nx - tile.getFirstRow();
+                GridCell cell;
+                for (int s = 0; s < ns; ++s) cell.concentrations[s] = tile.row(s, r)[cell_id % nx];
+                hash_table->updateCell(cell_id, cell);
+            }
+        }
+        double t3 = MPI_Wtime();
+
+        time_advect += t2 - t1;
+        time_advect_comm += (t1 - t0) + (t3 - t2);
+    }
+
+    void simulateReactions(int step) {
+        if (params.overlap_comm) {
+            simulateReactionsOverlapped(step);
+            return;
+        }
+        for (const CellRange& range : getComputeRanges()) {
+            double block_start = MPI_Wtime();
+            simulateRange(range.start_id, range.end_id);
+            if (balancer) balancer->recordBlockWork(range.block, MPI_Wtime() - block_start);
+        }
+    }
+
+    // Paso con solapamiento: las celdas interiores (la celda y sus cuatro
+    // vecinos son locales) se calculan mientras viajan las lecturas remotas que
+    // necesitan las celdas de frontera; después se completa la frontera.
+    void simulateReactionsOverlapped(int step) {
+        std::vector<CellRange> ranges = getComputeRanges();
+        std::vector<std::vector<int>> interior(ranges.size()), boundary(ranges.size());
+        FetchBatch halo;
+
+        // 1. Clasificar celdas y reunir las claves remotas (sin duplicados)
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            for (int cell_id = ranges[r].start_id; cell_id < ranges[r].end_id; ++cell_id) {
+                int ids[5];
+                ids[0] = cell_id;
+                getNeighborIds(cell_id, ids + 1);
+                bool remote = false;
+                for (int id : ids) {
+                    if (hash_table->getOwnerRank(id) != rank) {
+                        halo.keys.push_back(id);
+                        remote = true;
+                    }
+                }
+                (remote ? boundary[r] : interior[r]).push_back(cell_id);
+            }
+        }
+        std::sort(halo.keys.begin(), halo.keys.end());
+        halo.keys.erase(std::unique(halo.keys.begin(), halo.keys.end()), halo.keys.end());
+
+        if (halo_blocking_time < 0.0 || halo_calibrated_keys != halo.keys.size() ||
+            halo_calibrated_strategy != hash_table->getStrategyName()) {
+            FetchBatch probe;
+            probe.keys = halo.keys;
+            double t_probe = MPI_Wtime();
+            hash_table->startFetch(probe);
+            hash_table->completeFetch(probe);
+            halo_blocking_time = MPI_Wtime() - t_probe;
+            halo_calibrated_keys = halo.keys.size();
+            halo_calibrated_strategy = hash_table->getStrategyName();
+        }
+
+        // 2. Lanzar las lecturas remotas sin esperar
+        double t0 = MPI_Wtime();
+        hash_table->startFetch(halo);
+        double t_issue = MPI_Wtime() - t0;
+
+        // 3. Interior (solo datos locales) mientras llegan los halos
+        t0 = MPI_Wtime();
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            double block_start = MPI_Wtime();
+            simulateCells(interior[r], nullptr);
+            if (balancer) balancer->recordBlockWork(ranges[r].block, MPI_Wtime() - block_start);
+        }
+        double t_interior = MPI_Wtime() - t0;
+
+        // 4. Esperar los halos: este es el tiempo de comunicación no ocultado
+        t0 = MPI_Wtime();
+        hash_table->completeFetch(halo);
+        double t_wait = MPI_Wtime() - t0;
+
+        // 5. Frontera con los halos recibidos
+        t0 = MPI_Wtime();
+        for (size_t r = 0; r < ranges.size(); ++r) {
+            double block_start = MPI_Wtime();
+            simulateCells(boundary[r], &halo);
+            if (balancer) balancer->recordBlockWork(ranges[r].block, MPI_Wtime() - block_start);
+        }
+        double t_boundary = MPI_Wtime() - t0;
+
+        // Fracción ocultada: parte del coste bloqueante del lote que no quedó
+        // expuesta como lanzamiento + espera
+        double local_stats[7] = {t_issue, t_interior, t_wait, t_boundary,
+                                 (double)halo.keys.size(), 0.0, halo_blocking_time};
+        for (const auto& cells : interior) local_stats[5] += cells.size();
+        double stats[7];
+        MPI_Reduce(local_stats, stats, 7, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (rank == 0) {
+            double exposed = stats[0] + stats[2];
+            double hidden = stats[6] > 0.0 ? 1.0 - exposed / stats[6] : 0.0;
+            hidden = std::max(0.0, std::min(1.0, hidden));
+            std::cout << "[Overlap] step " << step
+                      << ": interior cells " << (long long)stats[5]
+                      << ", halo keys " << (long long)stats[4]
+                      << " | issue " << stats[0] / size * 1000.0
+                      << " ms, interior " << stats[1] / size * 1000.0
+                      << " ms, wait " << stats[2] / size * 1000.0
+                      << " ms, boundary " << stats[3] / size * 1000.0
+                      << " ms | overlap " << hidden * 100.0 << "%" << std::endl;
+        }
+    }
+
+    // Vecinos con condiciones de borde periódicas: izquierda, derecha, arriba, abajo
+    void getNeighborIds(int cell_id, int ids[4]) const {
+        int x = cell_id % params.grid_x;
+        int y = cell_id / params.grid_x;
+        ids[0] = (x > 0) ? cell_id - 1 : cell_id + params.grid_x - 1;
+        ids[1] = (x < params.grid_x - 1) ? cell_id + 1 : cell_id - params.grid_x + 1;
+        ids[2] = (y > 0) ? cell_id - params.grid_x : cell_id + (params.grid_y - 1) * params.grid_x;
+        ids[3] = (y < params.grid_y - 1) ? cell_id + params.grid_x : cell_id - (params.grid_y - 1) * params.grid_x;
+    }
+
+    // Lectura de una celda: del lote de halos si es remota y está en él,
+    // si no (o si el bucket no es válido) con getCell
+    GridCell readCell(int key, const FetchBatch* halo) {
+        if (halo && hash_table->getOwnerRank(key) != rank) {
+            auto it = std::lower_bound(halo->keys.begin(), halo->keys.end(), key);
+            if (it != halo->keys.end() && *it == key) {
+                GridCell cell;
+                if (hash_table->decodeFetched(halo->buckets[it - halo->keys.begin()], key, cell)) {
+                    return cell;
+                }
             }
-            
-            // D. REACCIÓN QUÍMICA (A + B -> C)
-            double delta = cell.concentrations[0] * cell.concentrations[1] * reaction_rate * params.dt;
-            cell.concentrations[0] -= delta;
-            cell.concentrations[1] -= delta;
-            cell.concentrations[2] += delta;
-            
-            // E. WRITE resultado
-            hash_table->updateCell(cell_id, cell);
         }
+        return hash_table->getCell(key);
+    }
+
+    void simulateRange(int start_id, int end_id) {
+        simulateBatch(end_id - start_id, [start_id](size_t i) { return start_id + (int)i; },
+                      nullptr);
+    }
+
+    void simulateCells(const std::vector<int>& cells, const FetchBatch* halo) {
+        simulateBatch(cells.size(), [&cells](size_t i) { return cells[i]; }, halo);
+    }
+
+    // Un lote de celdas en tres fases: lectura + difusión celda a celda,
+    // química sobre el lote completo en SoA, y escritura. Todas las lecturas
+    // del lote preceden a sus escrituras.
+    template <class CellIdOf>
+    void simulateBatch(size_t n, CellIdOf cell_id_of, const FetchBatch* halo) {
+        if (n == 0) return;
+        const int ns = params.num_species;
+        std::vector<GridCell> cells(n);
+        SpeciesBatch in(ns, n), out(ns, n);
+
+        // A. Transporte: lecturas (potencialmente remotas) y difusión
+        double t0 = MPI_Wtime();
+        #pragma omp parallel for schedule(static) if(hash_table->isThreadSafe())
+        for (size_t i = 0; i < n; ++i) {
+            cells[i] = diffuseCell(cell_id_of(i), halo);
+            for (int s = 0; s < ns; ++s) in.species(s)[i] = cells[i].concentrations[s];
+        }
+
+        // B. Química: solo cálculo local, siempre con todos los hilos
+        double t1 = MPI_Wtime();
+        kernel->react(in, out, params.dt);
+
+        // C. Escritura de resultados
+        double t2 = MPI_Wtime();
+        #pragma omp parallel for schedule(static) if(hash_table->isThreadSafe())
+        for (size_t i = 0; i < n; ++i) {
+            for (int s = 0; s < ns; ++s) cells[i].concentrations[s] = out.species(s)[i];
+            hash_table->updateCell(cell_id_of(i), cells[i]);
+        }
+        double t3 = MPI_Wtime();
+
+        time_transport += t1 - t0;
+        time_chemistry += t2 - t1;
+        time_write += t3 - t2;
+    }
+
+    GridCell diffuseCell(int cell_id, const FetchBatch* halo) {
+        double diffusion_coef = 0.1;
+
+        // A. READ celda actual
+        auto cell = readCell(cell_id, halo);
+
+        // B. READ celdas vecinas (acceso potencialmente remoto - aumenta contención)
+        int ids[4];
+        getNeighborIds(cell_id, ids);
+        GridCell left  = readCell(ids[0], halo);
+        GridCell right = readCell(ids[1], halo);
+        GridCell up    = readCell(ids[2], halo);
+        GridCell down  = readCell(ids[3], halo);
+
+        // C. DIFUSIÓN (Laplaciano discreto)
+        for (int s = 0; s < params.num_species; ++s) {
+            double laplacian = left.concentrations[s] + right.concentrations[s] 
+                             + up.concentrations[s] + down.concentrations[s] 
+                             - 4.0 * cell.concentrations[s];
+            cell.concentrations[s] += diffusion_coef * laplacian * params.dt;
+        }
+        return cell;
     }
 };
 
 int main(int argc, char** argv) {
     // Inicialización MPI estándar
-    MPI_Init(&argc, &argv);
+    // FUNNELED: los hilos OpenMP (carga masiva, backend de memoria compartida)
+    // nunca llaman a MPI; solo el hilo principal lo hace
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
     
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
+
+    if (provided < MPI_THREAD_FUNNELED) {
+        if (rank == 0) {
+            std::cerr << "ERROR: MPI library does not support MPI_THREAD_FUNNELED "
+                      << "(provided level " << provided << ")" << std::endl;
+        }
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
     
     SimulationParams params;
     params.grid_x = 500;
@@ -158,7 +563,10 @@ int main(int argc, char** argv) {
     // ---------------------------------------------------------
     // 1. Test Lock-Free (Optimistic Checksum)
     // ---------------------------------------------------------
-    if (rank == 0) std::cout << "\n[1/3] Testing Lock-Free Strategy..." << std::endl;
+    // Con un solo proceso se añaden las variantes en memoria compartida (OpenMP)
+    int num_tests = (size == 1) ? 12 : 9;
+
+    if (rank == 0) std::cout << "\n[1/" << num_tests << "] Testing Lock-Free Strategy..." << std::endl;
     
     // IMPORTANTE: MPI_Barrier para asegurar que todos inicien juntos
     MPI_Barrier(MPI_COMM_WORLD); 
@@ -174,7 +582,7 @@ int main(int argc, char** argv) {
     // 2. Test Coarse-Grained (Global Window Lock)
     // ---------------------------------------------------------
     MPI_Barrier(MPI_COMM_WORLD);
-    if (rank == 0) std::cout << "\n[2/3] Testing Coarse-Grained Locking..." << std::endl;
+    if (rank == 0) std::cout << "\n[2/" << num_tests << "] Testing Coarse-Grained Locking..." << std::endl;
     
     {
         auto coarse_table = std::make_unique<CoarseGrainedHashTable>(
@@ -187,7 +595,7 @@ int main(int argc, char** argv) {
     // 3. Test Fine-Grained (CAS - Atomic Operations)
     // ---------------------------------------------------------
     MPI_Barrier(MPI_COMM_WORLD);
-    if (rank == 0) std::cout << "\n[3/3] Testing Fine-Grained Locking..." << std::endl;
+    if (rank == 0) std::cout << "\n[3/" << num_tests << "] Testing Fine-Grained Locking..." << std::endl;
 
     {
         auto fine_table = std::make_unique<FineGrainedHashTable>(
@@ -196,6 +604,155 @@ int main(int argc, char** argv) {
         fine_sim.runSimulation();
     }
     
+    // ---------------------------------------------------------
+    // 4. Test Adaptive (selección de protocolo en tiempo de ejecución)
+    // ---------------------------------------------------------
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) std::cout << "\n[4/" << num_tests << "] Testing Adaptive Strategy..." << std::endl;
+
+    {
+        auto adaptive_table = std::make_unique<AdaptiveHashTable>(
+            total_cells, rank, size);
+        POETSimulator adaptive_sim(std::move(adaptive_table), params, rank, size);
+        adaptive_sim.runSimulation();
+    }
+
+    // ---------------------------------------------------------
+    // 5. Test Lock-Free con balanceo dinámico de carga
+    // ---------------------------------------------------------
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) std::cout << "\n[5/" << num_tests << "] Testing Lock-Free + Load Balancing..." << std::endl;
+
+    {
+        SimulationParams lb_params = params;
+        lb_params.load_balancing = true;
+        auto lb_table = std::make_unique<LockFreeHashTable>(
+            total_cells, rank, size);
+        POETSimulator lb_sim(std::move(lb_table), lb_params, rank, size);
+        lb_sim.runSimulation();
+    }
+
+    // ---------------------------------------------------------
+    // 6. Test Lock-Free con solapamiento comunicación/cálculo
+    // ---------------------------------------------------------
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) std::cout << "\n[6/" << num_tests << "] Testing Lock-Free + Comm/Compute Overlap..." << std::endl;
+
+    {
+        SimulationParams overlap_params = params;
+        overlap_params.overlap_comm = true;
+        auto overlap_table = std::make_unique<LockFreeHashTable>(
+            total_cells, rank, size);
+        POETSimulator overlap_sim(std::move(overlap_table), overlap_params, rank, size);
+        overlap_sim.runSimulation();
+    }
+
+    // ---------------------------------------------------------
+    // 7. Test Lock-Free con química rígida (Rosenbrock sobre Robertson)
+    // ---------------------------------------------------------
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) std::cout << "\n[7/" << num_tests << "] Testing Lock-Free + Stiff Chemistry..." << std::endl;
+
+    {
+        auto stiff_table = std::make_unique<LockFreeHashTable>(
+            total_cells, rank, size);
+        auto stiff_kernel = std::make_unique<RosenbrockReactionKernel>(
+            ReactionNetwork::robertsonNetwork(params.num_species));
+        POETSimulator stiff_sim(std::move(stiff_table), params, rank, size,
+                                std::move(stiff_kernel));
+        stiff_sim.runSimulation();
+    }
+
+    // ---------------------------------------------------------
+    // 8. Test Lock-Free con advección upwind antes de la química
+    // ---------------------------------------------------------
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) std::cout << "\n[8/" << num_tests << "] Testing Lock-Free + Advection..." << std::endl;
+
+    {
+        SimulationParams advection_params = params;
+        advection_params.advection = true;
+        auto advection_table = std::make_unique<LockFreeHashTable>(
+            total_cells, rank, size);
+        POETSimulator advection_sim(std::move(advection_table), advection_params, rank, size);
+        advection_sim.runSimulation();
+    }
+
+    // ---------------------------------------------------------
+    // 9. Capacidad: insertar más allá de la capacidad inicial
+    // ---------------------------------------------------------
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) std::cout << "\n[9/" << num_tests << "] Testing Capacity Management..." << std::endl;
+
+    {
+        // Tabla dimensionada para 50k entradas; 8 rondas insertan 200k claves
+        const int expected_entries = 50000;
+        const int keys_per_rank = 25000 / size;
+        const int rounds = 8;
+
+        {
+            LockFreeHashTable table(expected_entries, rank, size);
+            CapacityBenchmark bench(table, rank, size);
+            bench.printResults(bench.runInsertPastCapacity(keys_per_rank, rounds),
+                               "Lock-Free, online growth");
+        }
+        {
+            FineGrainedHashTable table(expected_entries, rank, size);
+            CapacityBenchmark bench(table, rank, size);
+            bench.printResults(bench.runInsertPastCapacity(keys_per_rank, rounds),
+                               "Fine-Grained, online growth");
+        }
+        {
+            // Tras cada crecimiento se rehacen las vistas sobre la ventana nueva
+            AdaptiveHashTable table(expected_entries, rank, size);
+            CapacityBenchmark bench(table, rank, size);
+            bench.printResults(bench.runInsertPastCapacity(keys_per_rank, rounds),
+                               "Adaptive, online growth");
+        }
+        {
+            CoarseGrainedHashTable table(expected_entries, rank, size);
+            CapacityBenchmark bench(table, rank, size);
+            bench.printResults(bench.runInsertPastCapacity(keys_per_rank, rounds),
+                               "Coarse-Grained, online growth");
+        }
+        {
+            CoarseGrainedHashTable table(expected_entries, rank, size);
+            table.setOverflowPolicy(OverflowPolicy::EVICT_CLOCK, 8);
+            CapacityBenchmark bench(table, rank, size);
+            bench.printResults(bench.runInsertPastCapacity(keys_per_rank, rounds),
+                               "Coarse-Grained, cache mode (CLOCK, 8-way)");
+        }
+        {
+            CoarseGrainedHashTable table(expected_entries, rank, size);
+            table.setOverflowPolicy(OverflowPolicy::EVICT_RANDOM, 8);
+            CapacityBenchmark bench(table, rank, size);
+            bench.printResults(bench.runInsertPastCapacity(keys_per_rank, rounds),
+                               "Coarse-Grained, cache mode (random, 8-way)");
+        }
+    }
+
+    // ---------------------------------------------------------
+    // 10-12. Memoria compartida (solo ejecución en un único proceso)
+    // ---------------------------------------------------------
+    if (size == 1) {
+        const SharedConsistency shared_modes[] = {
+            SharedConsistency::OPTIMISTIC_VERSION,
+            SharedConsistency::PARTITION_LOCK,
+            SharedConsistency::BUCKET_CAS
+        };
+        int test_id = 10;
+        for (SharedConsistency mode : shared_modes) {
+            std::cout << "\n[" << test_id++ << "/" << num_tests
+                      << "] Testing Shared-Memory Backend ("
+                      << omp_get_max_threads() << " threads)..." << std::endl;
+
+            auto shared_table = std::make_unique<SharedMemoryHashTable>(
+                total_cells, mode);
+            POETSimulator shared_sim(std::move(shared_table), params, rank, size);
+            shared_sim.runSimulation();
+        }
+    }
+    
     if (rank == 0) std::cout << "\nAll benchmarks finished." << std::endl;
     
     MPI_Finalize();
@@ -0,0 +1,278 @@
+#ifndef SHARED_MEMORY_HASH_TABLE_HPP
+#define SHARED_MEMORY_HASH_TABLE_HPP
+
+#include "distributed_hash_table.hpp"
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <shared_mutex>
+#include <mutex>
+#include <thread>
+#include <omp.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Backend en memoria compartida (un solo proceso, varios hilos OpenMP).
+// Implementa la misma interfaz que las estrategias MPI RMA pero sobre
+// buckets con std::atomic, para medir el overhead de RMA frente a memoria
+// nativa en el mismo hardware.
+
+// Pausa dentro de un bucle de espera activa: cede recursos del núcleo al
+// hilo hermano (hyperthreading), que puede ser el que tiene el lock
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Las tres variantes de consistencia, análogas a las estrategias MPI
+enum class SharedConsistency {
+    PARTITION_LOCK,    // Análogo a Coarse-Grained: un lock lector/escritor por partición
+    BUCKET_CAS,        // Análogo a Fine-Grained: spinlock CAS por bucket
+    OPTIMISTIC_VERSION // Análogo a Lock-Free: lectores sin lock, validan versión (seqlock)
+};
+
+// Un bucket por línea de caché: 4 (key) + 4 (version) + 56 (GridCell) = 64 bytes
+struct alignas(64) SHM_Bucket {
+    std::atomic<int> key;               // -1 = Vacío
+    std::atomic<unsigned int> version;  // Par = estable, impar = escritura en curso
+    GridCell value;
+};
+
+static_assert(std::is_trivially_destructible<SHM_Bucket>::value,
+              "Los buckets se liberan sin llamar a sus destructores");
+
+class SharedMemoryHashTable final : public DistributedHashTable {
+private:
+    static constexpr int EMPTY_KEY = -1;
+
+    // Lock por partición separado en su propia línea de caché (evita false sharing)
+    struct alignas(64) PartitionLock {
+        std::shared_mutex mutex;
+    };
+
+    // Memoria reservada sin construir (ver constructor): solo se libera
+    struct AlignedBucketDelete {
+        void operator()(SHM_Bucket* p) const {
+            ::operator delete(p, std::align_val_t(alignof(SHM_Bucket)));
+        }
+    };
+
+    SharedConsistency consistency;
+    int num_partitions;
+    size_t keys_per_partition;  // Rango contiguo de claves de cada partición
+    size_t partition_capacity;
+    std::unique_ptr<SHM_Bucket[], AlignedBucketDelete> buckets;
+    std::unique_ptr<PartitionLock[]> partition_locks;
+
+public:
+    SharedMemoryHashTable(int total_entries, SharedConsistency consistency,
+                          int num_threads = omp_get_max_threads())
+        : DistributedHashTable(0, 1), consistency(consistency),
+          num_partitions(num_threads > 0 ? num_threads : 1) {
+
+        // Partición p = claves [p * keys_per_partition, (p + 1) * keys_per_partition),
+        // el mismo reparto que un bucle schedule(static) sobre las celdas.
+        // Misma holgura que la versión MPI: el doble de lo esperado por partición
+        keys_per_partition = (static_cast<size_t>(std::max(total_entries, 1)) +
+                              num_partitions - 1) / num_partitions;
+        partition_capacity = keys_per_partition * 2;
+        if (partition_capacity < 100) partition_capacity = 100;
+
+        // Reserva sin construir: new SHM_Bucket[] tocaría todas las páginas
+        // desde este hilo y las dejaría en su nodo NUMA
+        const size_t capacity = partition_capacity * num_partitions;
+        buckets.reset(static_cast<SHM_Bucket*>(
+            ::operator new(capacity * sizeof(SHM_Bucket), std::align_val_t(alignof(SHM_Bucket)))));
+        partition_locks.reset(new PartitionLock[num_partitions]);
+
+        // Cada hilo construye (first-touch) su propia partición, de modo que
+        // en máquinas NUMA la memoria quede en el nodo del hilo que la usa.
+        #pragma omp parallel for schedule(static, 1) num_threads(num_partitions)
+        for (int p = 0; p < num_partitions; ++p) {
+            SHM_Bucket* part = buckets.get() + p * partition_capacity;
+            for (size_t i = 0; i < partition_capacity; ++i) {
+                SHM_Bucket* b = new (part + i) SHM_Bucket();
+                b->key.store(EMPTY_KEY, std::memory_order_relaxed);
+                b->version.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    void updateCell(int key, const GridCell& val) override {
+        int part = partitionOf(key);
+
+        if (consistency == SharedConsistency::PARTITION_LOCK) {
+            std::unique_lock<std::shared_mutex> lock(partition_locks[part].mutex);
+            SHM_Bucket* b = claimBucket(key);
+            if (b) b->value = val;
+            return;
+        }
+
+        SHM_Bucket* b = claimBucket(key);
+        if (!b) return; // Partición llena
+
+        // BUCKET_CAS y OPTIMISTIC_VERSION comparten el lado escritor:
+        // versión par -> impar (lock), escribir, impar -> par (unlock)
+        unsigned int v = lockBucket(b);
+        b->value = val;
+        b->version.store(v + 2, std::memory_order_release);
+    }
+
+    GridCell getCell(int key) override {
+        int part = partitionOf(key);
+
+        switch (consistency) {
+        case SharedConsistency::PARTITION_LOCK: {
+            std::shared_lock<std::shared_mutex> lock(partition_locks[part].mutex);
+            SHM_Bucket* b = findBucket(key);
+            return b ? b->value : GridCell();
+        }
+        case SharedConsistency::BUCKET_CAS: {
+            SHM_Bucket* b = findBucket(key);
+            if (!b) return GridCell();
+            unsigned int v = lockBucket(b);
+            GridCell result = b->value;
+            b->version.store(v, std::memory_order_release); // Lectura: no cambia versión
+            return result;
+        }
+        case SharedConsistency::OPTIMISTIC_VERSION:
+        default: {
+            SHM_Bucket* b = findBucket(key);
+            if (!b) return GridCell();
+            // Seqlock: copiar y validar que la versión no cambió durante la copia
+            while (true) {
+                unsigned int v1 = b->version.load(std::memory_order_acquire);
+                if (v1 & 1u) { cpuRelax(); continue; } // Escritor en curso
+                GridCell result = b->value;
+                std::atomic_thread_fence(std::memory_order_acquire);
+                unsigned int v2 = b->version.load(std::memory_order_relaxed);
+                if (v1 == v2) return result;
+                cpuRelax();
+            }
+        }
+        }
+    }
+
+    std::string getStrategyName() const override {
+        switch (consistency) {
+        case SharedConsistency::PARTITION_LOCK:
+            return "Shared-Memory Partition Lock (std::shared_mutex)";
+        case SharedConsistency::BUCKET_CAS:
+            return "Shared-Memory Per-Bucket CAS (std::atomic)";
+        case SharedConsistency::OPTIMISTIC_VERSION:
+        default:
+            return "Shared-Memory Optimistic (Seqlock)";
+        }
+    }
+
+    bool isThreadSafe() const override { return true; }
+
+    // Sin red: el lote se resuelve al momento con getCell
+    void startFetch(FetchBatch& batch) override {
+        batch.buckets.resize(batch.keys.size());
+        for (size_t i = 0; i < batch.keys.size(); ++i) {
+            batch.buckets[i].key = batch.keys[i];
+            batch.buckets[i].value = getCell(batch.keys[i]);
+            batch.buckets[i].control = makeControl(BUCKET_OCCUPIED, 0);
+        }
+    }
+
+    void completeFetch(FetchBatch&) override {}
+
+    MemoryUsage getLocalMemoryUsage() const override {
+        size_t capacity = partition_capacity * num_partitions;
+        size_t occupied = 0;
+        #pragma omp parallel for reduction(+:occupied) schedule(static)
+        for (size_t i = 0; i < capacity; ++i) {
+            if (buckets[i].key.load(std::memory_order_relaxed) != EMPTY_KEY) occupied++;
+        }
+        return MemoryUsage{sizeof(SHM_Bucket), capacity, occupied};
+    }
+
+    // Un solo proceso: no hay nada que redistribuir, solo insertar en paralelo
+    void bulkLoad(const std::vector<std::pair<int, GridCell>>& entries) override {
+        #pragma omp parallel for schedule(static)
+        for (size_t i = 0; i < entries.size(); ++i) {
+            updateCell(entries[i].first, entries[i].second);
+        }
+    }
+
+    // No hay ventana que vaciar: el fin de la región OpenMP ya actúa de barrera
+    void syncGhostCells() override {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+private:
+    // Las claves por encima del total esperado van a la última partición
+    int partitionOf(int key) const {
+        size_t p = static_cast<size_t>(key) / keys_per_partition;
+        return static_cast<int>(std::min<size_t>(p, num_partitions - 1));
+    }
+
+    SHM_Bucket* partitionBase(int key) const {
+        return buckets.get() + partitionOf(key) * partition_capacity;
+    }
+
+    // Posición inicial dentro de la partición: el desplazamiento en su rango
+    size_t partitionSlot(int key) const {
+        return (static_cast<size_t>(key) - partitionOf(key) * keys_per_partition) %
+               partition_capacity;
+    }
+
+    // Linear probing dentro de la partición: devuelve el bucket de la clave o
+    // reserva uno vacío con CAS sobre el campo key (sin locks).
+    SHM_Bucket* claimBucket(int key) {
+        SHM_Bucket* part = partitionBase(key);
+        size_t slot = partitionSlot(key);
+
+        for (size_t attempts = 0; attempts < partition_capacity; ++attempts) {
+            SHM_Bucket* b = part + slot;
+            int current = b->key.load(std::memory_order_acquire);
+            if (current == key) return b;
+            if (current == EMPTY_KEY) {
+                int expected = EMPTY_KEY;
+                if (b->key.compare_exchange_strong(expected, key,
+                                                   std::memory_order_acq_rel)) {
+                    return b;
+                }
+                if (expected == key) return b; // Otro hilo reservó la misma clave
+            }
+            slot = (slot + 1) % partition_capacity;
+        }
+        return nullptr;
+    }
+
+    SHM_Bucket* findBucket(int key) const {
+        SHM_Bucket* part = partitionBase(key);
+        size_t slot = partitionSlot(key);
+
+        for (size_t attempts = 0; attempts < partition_capacity; ++attempts) {
+            SHM_Bucket* b = part + slot;
+            int current = b->key.load(std::memory_order_acquire);
+            if (current == key) return b;
+            if (current == EMPTY_KEY) return nullptr; // Hueco vacío -> no existe
+            slot = (slot + 1) % partition_capacity;
+        }
+        return nullptr;
+    }
+
+    // Spinlock sobre la versión: espera a versión par y la pasa a impar.
+    // Devuelve la versión (par) previa.
+    unsigned int lockBucket(SHM_Bucket* b) {
+        while (true) {
+            unsigned int v = b->version.load(std::memory_order_relaxed);
+            if (!(v & 1u) &&
+                b->version.compare_exchange_weak(v, v + 1, std::memory_order_acquire)) {
+                return v;
+            }
+            cpuRelax();
+        }
+    }
+};
+
+#endif // SHARED_MEMORY_HASH_TABLE_HPP